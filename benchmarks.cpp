@@ -0,0 +1,78 @@
+#include "simpleJSON.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Times a function and returns the elapsed wall clock time in milliseconds
+template <typename F>
+double timeMilliseconds(F&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void benchParseBatch() {
+    using namespace simpleJSON;
+
+    auto events = parseFromFile("testInputs/mediumJson.json");
+    std::vector<std::string> texts;
+
+    // many small independent documents
+    for (int repeat = 0; repeat < 20; ++repeat) {
+        for (size_t i = 0; i < events.size(); ++i) {
+            texts.push_back(dumpToString(events[i]));
+        }
+    }
+
+    std::vector<std::string_view> documents(texts.begin(), texts.end());
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "parseBatch, " << documents.size() << " documents" << std::endl;
+
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        double ms = timeMilliseconds([&]() { parseBatch(documents, threads); });
+        std::cout << "  threads: " << threads << "  time: " << ms << " ms  documents/s: " << size_t(documents.size() / (ms / 1000)) << std::endl;
+    }
+}
+
+void benchParallelDump() {
+    using namespace simpleJSON;
+
+    auto document = parseFromFile("testInputs/veryBigJson.json");
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    double sequential = timeMilliseconds([&]() { dumpToString(document); });
+    std::cout << "dumpToString, veryBigJson" << std::endl;
+    std::cout << "  sequential  time: " << sequential << " ms" << std::endl;
+
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        double ms = timeMilliseconds([&]() { dumpToStringParallel(document, threads); });
+        std::cout << "  threads: " << threads << "  time: " << ms << " ms" << std::endl;
+    }
+}
+
+void benchMinify() {
+    using namespace simpleJSON;
+
+    std::string pretty = dumpToPrettyString(parseFromFile("testInputs/veryBigJson.json"));
+    double megabytes = double(pretty.size()) / (1 << 20);
+
+    double viaDocument = timeMilliseconds([&]() { dumpToString(parseFromString(pretty)); });
+    double streaming = timeMilliseconds([&]() { minify(pretty); });
+
+    std::cout << "minify, pretty veryBigJson (" << size_t(megabytes) << " MB)" << std::endl;
+    std::cout << "  parse + dumpToString  time: " << viaDocument << " ms  MB/s: " << size_t(megabytes / (viaDocument / 1000)) << std::endl;
+    std::cout << "  minify                time: " << streaming << " ms  MB/s: " << size_t(megabytes / (streaming / 1000)) << std::endl;
+}
+
+int main() {
+    benchParseBatch();
+    benchParallelDump();
+    benchMinify();
+
+    return 0;
+}
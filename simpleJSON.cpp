@@ -0,0 +1,6 @@
+// Compiled-library build of simpleJSON, see SIMPLEJSON_COMPILED_LIBRARY in simpleJSON.hpp
+#ifndef SIMPLEJSON_COMPILED_LIBRARY
+#define SIMPLEJSON_COMPILED_LIBRARY
+#endif
+#define SIMPLEJSON_IMPLEMENTATION
+#include "simpleJSON.hpp"
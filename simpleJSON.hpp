@@ -1,15 +1,66 @@
 #ifndef __SIMPLE_JSON__
 #define __SIMPLE_JSON__
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
 #include <exception>
 #include <fstream>
+#include <functional>
 #include <initializer_list>
+#include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SIMPLEJSON_HAS_MMAP
+#endif
+
+#if defined(__linux__) && defined(SIMPLEJSON_HAS_MMAP) && __has_include(<linux/io_uring.h>) && __has_include(<sys/syscall.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+// openat, read and close opcodes arrived together with IORING_FEAT_RW_CUR_POS (Linux 5.6)
+#if defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define SIMPLEJSON_HAS_IO_URING
+#endif
+#endif
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define SIMPLEJSON_HAS_COROUTINES
+#endif
+
 // #define DEBUG
 
 #ifdef DEBUG    
@@ -20,8 +71,52 @@
     #define FUNCTRACE while(0){};
 #endif
 
+// By default the library is header-only and may be included in any number of translation units.
+// Define SIMPLEJSON_COMPILED_LIBRARY everywhere the header is included and link simpleJSON.cpp (make lib)
+// to compile the non-template code only once.
+#ifdef SIMPLEJSON_COMPILED_LIBRARY
+    #define SIMPLEJSON_INLINE
+#else
+    #define SIMPLEJSON_INLINE inline
+#endif
+
+#if defined(SIMPLEJSON_COMPILED_LIBRARY) && !defined(SIMPLEJSON_IMPLEMENTATION)
+    #define SIMPLEJSON_DEFINE_NON_TEMPLATES 0
+#else
+    #define SIMPLEJSON_DEFINE_NON_TEMPLATES 1
+#endif
+
 //------------------------------------- API -------------------------------------
 
+namespace internal {
+    struct StaticJSONNode__internal;
+
+    // Structural JSON grammar shared by JSONTokenizer and the in-memory minifier: the open containers and what may
+    // come next. Callers find and validate strings, numbers and literals themselves, offsets are positions in the
+    // whole input. Violations throw simpleJSON::JSONSyntaxError.
+    struct JSONSyntaxState__internal {
+        enum class Expect { VALUE, VALUE_OR_END_ARRAY, KEY, KEY_OR_END_OBJECT, COLON, COMMA_OR_END, NOTHING };
+
+        std::vector<char> containers;
+        Expect expect = Expect::VALUE;
+
+        void reset();
+        // One of {}[],: at offset
+        void structural(const char c, const size_t offset);
+        void beginString(const size_t offset) const;
+        // Returns whether the string that just ended was a key
+        bool endString();
+        // Start of a number or literal
+        void beginValue(const size_t offset) const;
+        void afterValue();
+        // Throws unless a whole top level value has been read, offset is the end of input
+        void finish(const size_t offset) const;
+        bool isComplete() const;
+        // Anything that does not fit at offset, reported as what was expected there
+        [[noreturn]] void unexpected(const size_t offset) const;
+    };
+} // namespace internal
+
 namespace simpleJSON {
     class JSONString;
     class JSONNumber;
@@ -29,29 +124,179 @@ namespace simpleJSON {
     class JSONNull;
     class JSONArray;
     class JSONObject;
+    class JSONPointer;
+    class JSONTokenizer;
+    class JSONStreamParser;
+    class JSONWriter;
+    class JSONFilter;
+    class SHA256;
+    class SharedDocument;
+    struct JSONKey;
+    struct JSONKeyLess;
+    class StaticJSONView;
+    template <size_t NodeCount>
+    class StaticJSON;
+    class JSONSnapshot;
+    class JSONSnapshotView;
+    class BinaryWriter;
+    class BinaryReader;
+    struct BSONCodec;
+    struct UBJSONCodec;
+
+    // Value types used by the library. To change them, define a struct with the same members and name it in
+    // SIMPLEJSON_TRAITS before including this header. Floating may be float, double or long double, Integral any
+    // signed integer type. ObjectMap must behave like std::map, Compare is the transparent key ordering to use.
+    // ObjectMap may bring its own allocator, but it has to be an ordered map: lookups rely on the transparent
+    // comparator and output relies on key order, so hash maps cannot be plugged in. Strings are always std::string,
+    // arrays always std::vector with std::allocator, and keys are always ordered by JSONKeyLess.
+    // Every translation unit of a program has to see the same traits. With SIMPLEJSON_COMPILED_LIBRARY the library
+    // has to be compiled with them as well, a mismatch fails to link with an undefined reference to
+    // internal::libraryCompiledWithSameTraits__internal. Two different structs with the same name are not detected.
+    struct DefaultJSONTraits {
+        using Floating = long double;
+        using Integral = long long int;
+        template <typename Key, typename Value, typename Compare>
+        using ObjectMap = std::map<Key, Value, Compare>;
+    };
+
+#ifdef SIMPLEJSON_TRAITS
+    using JSONTraits = SIMPLEJSON_TRAITS;
+#else
+    using JSONTraits = DefaultJSONTraits;
+#endif
+
+    using JSONFloating = JSONTraits::Floating;
+    using JSONIntegral = JSONTraits::Integral;
+    using JSONMap = JSONTraits::ObjectMap<JSONString, JSONObject, JSONKeyLess>;
 
-    // When changing what types are used as JSONFloating and JSONIntegral, also change how they are parsed
-    // in strToJSONFloating__internal and strToJSONIntegral__internal
-    using JSONFloating = long double;
-    using JSONIntegral = long long int;
+    static_assert(std::is_floating_point_v<JSONFloating>, "JSONTraits::Floating must be a floating point type");
+    static_assert(std::is_integral_v<JSONIntegral> && std::is_signed_v<JSONIntegral>, "JSONTraits::Integral must be a signed integer type");
 
     // You may change this to suit your needs
-    const std::string defaultIndentString = "\t";
+    inline const std::string defaultIndentString = "\t";
+
+    enum class SortOrder {
+        ASCENDING,
+        DESCENDING
+    };
 
     JSONObject parseFromFile(const char* fileName);
-    JSONObject parseFromString(std::string& jsonString);
+    JSONObject parseFromString(const std::string& jsonString);
     // void dumpToFile(const char* fileName);
     std::string dumpToString(const JSONObject& obj);
     std::string dumpToPrettyString(const JSONObject& obj, const std::string& indentString = defaultIndentString);
 
+    struct PrettyPrintOptions {
+        std::string indentString = defaultIndentString;
+        // Written between a key and its value
+        std::string keySeparator = " : ";
+        // Arrays of at most this many numbers, strings, booleans and nulls are written on one line, like [1, 2, 3]
+        size_t compactArrayLimit = 0;
+    };
+
+    std::string dumpToPrettyString(const JSONObject& obj, const PrettyPrintOptions& options);
+
+    // Exact number of bytes dumpToString and dumpToPrettyString(obj, options) produce, computed without
+    // building the string. Use it to size buffers or files before writing.
+    size_t measure(const JSONObject& obj);
+    size_t measure(const JSONObject& obj, const PrettyPrintOptions& options);
+    // Produce the same output as dumpToString and dumpToPrettyString, large arrays and objects are split
+    // into chunks that are serialized on threadCount threads (0 = one per hardware thread)
+    std::string dumpToStringParallel(const JSONObject& obj, const size_t threadCount = 0);
+    std::string dumpToPrettyStringParallel(const JSONObject& obj, const std::string& indentString = defaultIndentString, const size_t threadCount = 0);
+
+    // Binary snapshots are flat, offset-based images of a JSONObject that can be mapped into memory
+    // and queried in place, without parsing. They are meant to be read on the machine that wrote them.
+    void saveSnapshot(const JSONObject& obj, const char* fileName);
+    std::string dumpToSnapshotString(const JSONObject& obj);
+
+    // Returns an immutable document that any number of threads may read at the same time without locking.
+    // Const access to a packed array builds a cache of its elements on first use (see JSONArray). Packed arrays
+    // are unpacked up front, so readers of the result never allocate or synchronize to get element references.
+    std::shared_ptr<const JSONObject> freeze(JSONObject obj);
+
+    // Binary formats are plugged in as codecs, a type with static encode(BinaryWriter&, const JSONObject&)
+    // and decode(BinaryReader&) functions. BSONCodec and UBJSONCodec are provided.
+    template <typename Codec>
+    std::string dumpToBinary(const JSONObject& obj);
+    template <typename Codec>
+    JSONObject parseFromBinary(std::string_view bytes);
+
+    std::string dumpToBSON(const JSONObject& obj);
+    JSONObject parseFromBSON(std::string_view bytes);
+    std::string dumpToUBJSON(const JSONObject& obj);
+    JSONObject parseFromUBJSON(std::string_view bytes);
+
+    // Struct binding. Parses JSON straight into C++ types and serializes them back without building JSONObjects.
+    // Supported are bool, integral and floating point types, std::string, std::vector, std::optional
+    // and structs registered by specializing JSONBinding:
+    //
+    //     template <> struct simpleJSON::JSONBinding<Point> {
+    //         static constexpr auto fields = std::make_tuple(SIMPLEJSON_FIELD(Point, x), SIMPLEJSON_FIELD(Point, y));
+    //     };
+    //
+    // Unknown keys are skipped, missing keys leave the member untouched.
+    template <typename T>
+    struct JSONBinding;
+
+    template <typename Class, typename Member>
+    struct JSONField {
+        std::string_view name;
+        uint64_t hash;
+        Member Class::* member;
+    };
+
+    template <typename Class, typename Member>
+    constexpr JSONField<Class, Member> bindField(std::string_view name, Member Class::* member);
+
+    template <typename T>
+    T parseStructFromString(std::string_view jsonString);
+    template <typename T>
+    T parseStructFromFile(const char* fileName);
+    template <typename T>
+    std::string dumpStructToString(const T& val);
+
     class JSONException : public std::exception {
         public:
             JSONException(const char* msg);
+            JSONException(const std::string& msg);
 
             const char * what () const throw ();
 
         private:
-            const char* message;
+            std::string message;
+    };
+
+    enum class JSONSyntaxErrorKind {
+        UNEXPECTED_END_OF_INPUT,
+        EXPECTED_END_OF_INPUT,
+        EXPECTED_KEY,
+        EXPECTED_COLON,
+        EXPECTED_COMMA_OR_END,
+        UNEXPECTED_CHARACTER,
+        CONTROL_CHARACTER_IN_STRING,
+        INVALID_UNICODE_ESCAPE,
+        INVALID_ESCAPE,
+        UNTERMINATED_STRING,
+        INVALID_NUMBER,
+        EXPECTED_FRACTION_DIGITS,
+        EXPECTED_EXPONENT_DIGITS,
+        INVALID_LITERAL
+    };
+
+    // Thrown for malformed input by the validating parsers: JSONTokenizer, JSONStreamParser, the DOM-free minify
+    // and prettify, and static JSON. offset counts bytes from the start of the whole input, however it was split
+    // into chunks. source names the parser in the message, "Error while parsing <source>, <problem> (at byte <offset>)".
+    class JSONSyntaxError : public JSONException {
+        public:
+            JSONSyntaxError(const JSONSyntaxErrorKind kind, const size_t offset, const char* source = "JSON");
+
+            JSONSyntaxErrorKind getKind() const;
+            size_t getOffset() const;
+
+        private:
+            JSONSyntaxErrorKind kind;
+            size_t offset;
     };
 
     class JSONString {
@@ -68,12 +313,47 @@ namespace simpleJSON {
             friend bool operator>=(const JSONString& lhs, const JSONString& rhs);
 
             std::string getString() const;
+            std::string_view getStringView() const;
             std::string toString() const;
 
         private:
+            friend struct JSONKeyLess;
+
             std::string value;
     };
 
+    // Object key whose length and hash are computed at compile time when created with operator""_k.
+    // Looking a JSONKey up in a JSONObject does not construct a temporary JSONString.
+    struct JSONKey {
+        constexpr explicit JSONKey(std::string_view name);
+
+        friend constexpr bool operator==(const JSONKey& lhs, const JSONKey& rhs);
+        friend constexpr bool operator!=(const JSONKey& lhs, const JSONKey& rhs);
+
+        std::string_view name;
+        uint64_t hash;
+    };
+
+    // Transparent ordering of object keys, lets a JSONMap be searched with a JSONKey or any
+    // string-like key without building a JSONString for it
+    struct JSONKeyLess {
+        using is_transparent = void;
+
+        bool operator()(const JSONString& lhs, const JSONString& rhs) const;
+        template <typename K>
+        bool operator()(const JSONString& lhs, const K& rhs) const;
+        template <typename K>
+        bool operator()(const K& lhs, const JSONString& rhs) const;
+
+        template <typename K>
+        static std::string_view keyView(const K& key);
+    };
+
+    namespace literals {
+        // "login"_k
+        constexpr JSONKey operator""_k(const char* name, size_t length);
+    }   // namespace literals
+
     class JSONNumber {
         public:
             JSONNumber();
@@ -87,6 +367,8 @@ namespace simpleJSON {
             friend bool operator>(const JSONNumber& lhs, const JSONNumber& rhs);
             friend bool operator>=(const JSONNumber& lhs, const JSONNumber& rhs);
 
+            bool isFloating() const;
+            bool isIntegral() const;
             JSONFloating getFloating() const;
             JSONIntegral getIntegral() const;
             std::string toString() const;
@@ -121,10 +403,73 @@ namespace simpleJSON {
             std::string toString() const;
     };
 
+    // Publishes frozen documents to concurrent readers, read-copy-update style. Readers take the current
+    // version with load() and may use it for as long as they hold the pointer. Publishing a new version does not
+    // wait for readers to finish with the old one, it is freed when its last reader releases it.
+    // This is lock-based, not lock-free: the pointer is swapped with the std::atomic_load / std::atomic_store
+    // shared_ptr functions, which standard libraries implement with a small pool of mutexes. The lock is held
+    // only for the pointer copy and its reference count update, never while a document is parsed, copied or read.
+    class SharedDocument {
+        public:
+            SharedDocument();
+            explicit SharedDocument(JSONObject obj);
+
+            SharedDocument(const SharedDocument&) = delete;
+            SharedDocument& operator=(const SharedDocument&) = delete;
+
+            std::shared_ptr<const JSONObject> load() const;
+            void store(JSONObject obj);
+            // Parses the file before publishing it. On error the current document stays in place.
+            void reloadFromFile(const char* fileName);
+            // Publishes func applied to a copy of the current document. If another thread publishes in the
+            // meantime, func is called again on the newer version.
+            template <typename F>
+            void update(F&& func);
+
+        private:
+            std::shared_ptr<const JSONObject> document;
+    };
+
+    // JSON Pointer (RFC 6901), e.g. "/actor/login" or "/items/0". The empty pointer refers to the whole value.
+    class JSONPointer {
+        public:
+            JSONPointer();
+            JSONPointer(const char* pointer);
+            JSONPointer(const std::string& pointer);
+
+            friend bool operator==(const JSONPointer& lhs, const JSONPointer& rhs);
+            friend bool operator!=(const JSONPointer& lhs, const JSONPointer& rhs);
+
+            // Returns nullptr when the pointer does not refer to an existing value. Never inserts.
+            // With scratch, an element of a packed array is copied into scratch and &scratch is returned, so that
+            // the array does not have to build its element cache (see JSONArray) for a single lookup.
+            const JSONObject* resolve(const JSONObject& obj, JSONObject& scratch) const;
+            const JSONObject* resolve(const JSONObject& obj) const;
+            const std::vector<std::string>& getTokens() const;
+            // The pointer to the given field or array index below the value this pointer refers to
+            JSONPointer child(const std::string& token) const;
+            std::string toString() const;
+
+        private:
+            const JSONObject* resolveInto(const JSONObject& obj, JSONObject* scratch) const;
+
+            std::vector<std::string> tokens;
+    };
+
+    // Arrays whose elements are all integers or all floating point numbers are stored packed, as a plain vector
+    // of numbers. Appending any other kind of value, calling unpack or taking a reference to an element with
+    // the non-const operator[] converts the array back to a vector of JSONObjects. Const member functions never
+    // change the storage, so a const array can be read from several threads. The const operator[] of a packed
+    // array refers into a cache of its elements as JSONObjects, built on first use and dropped by any change
+    // to the array. get and forEach read packed elements without building it.
     class JSONArray {
         public:
             JSONArray();
             JSONArray(const std::initializer_list<JSONObject> list);
+            JSONArray(const JSONArray& other);
+            JSONArray(JSONArray&& other) = default;
+            JSONArray& operator=(const JSONArray& other);
+            JSONArray& operator=(JSONArray&& other) = default;
 
             template <typename T>
             void append(T&& arg);
@@ -133,17 +478,76 @@ namespace simpleJSON {
 
             JSONObject& operator[](const size_t index);
             const JSONObject& operator[](const size_t index) const;
+            // Copy of the element at index, works for packed and unpacked arrays alike
+            JSONObject get(const size_t index) const;
+
+            template <typename F>
+            void forEach(F&& func) const;
+            // Same as forEach, limited to the elements in [begin, end)
+            template <typename F>
+            void forEachInRange(const size_t begin, const size_t end, F&& func) const;
 
             friend bool operator==(const JSONArray& lhs, const JSONArray& rhs);
             friend bool operator!=(const JSONArray& lhs, const JSONArray& rhs);
             
+            // Aggregations over numeric arrays. Integers are summed exactly, the sum is integral if every element is
+            // and the total fits into JSONIntegral, floating point otherwise. Packed and unpacked arrays with the same
+            // elements give the same result. Non-numeric elements throw.
+            JSONNumber sum() const;
+            JSONNumber min() const;
+            JSONNumber max() const;
+            JSONFloating mean() const;
+            // Counts elements into bucketCount equal width buckets over [lowerBound, upperBound].
+            // Elements outside of the range are not counted.
+            std::vector<size_t> histogram(const JSONFloating lowerBound, const JSONFloating upperBound, const size_t bucketCount) const;
+
+            // Secondary indexes over the value found at keyPath inside each element (string and number keys only).
+            // They are kept up to date by append, pop and clear. Changes made through operator[] are not tracked,
+            // call buildIndex again after modifying indexed keys that way.
+            void buildIndex(const JSONPointer& keyPath, const bool sorted = false);
+            void dropIndex(const JSONPointer& keyPath);
+            bool hasIndex(const JSONPointer& keyPath) const;
+            // Positions of the elements whose key equals the given key, in ascending order
+            std::vector<size_t> findByKey(const JSONPointer& keyPath, const JSONObject& key) const;
+            // Positions of the elements whose key is in [lowerKey, upperKey], ordered by key. Requires a sorted index.
+            std::vector<size_t> findByKeyRange(const JSONPointer& keyPath, const JSONObject& lowerKey, const JSONObject& upperKey) const;
+
+            // Stable sort by the string or number found at keyPath inside each element. Keys are extracted once,
+            // large arrays are merge sorted on threadCount threads (0 means one per hardware thread)
+            // and elements are moved, never copied, into their final positions.
+            void sortBy(const JSONPointer& keyPath, const SortOrder order = SortOrder::ASCENDING, const size_t threadCount = 0);
+
             size_t size() const;
             void clear();
+            bool isPacked() const;
+            // Converts packed storage to a vector of JSONObjects so that references to elements can be taken
+            void unpack();
             std::string toString() const;
             std::string toIndentedString(std::string& currentIndentation, const std::string& indentString) const;
 
         private:
-            std::vector<JSONObject> value;
+            friend class JSONObject;
+
+            struct KeyIndex {
+                JSONPointer keyPath;
+                bool sorted;
+                // keys are hashed by their serialized form, so "1" and 1 are different keys
+                std::unordered_map<std::string, std::vector<size_t>> hashed;
+                std::multimap<JSONString, size_t> sortedStrings;
+                std::multimap<JSONNumber, size_t> sortedNumbers;
+            };
+
+            void appendNumber(const JSONNumber& num);
+            void updateIndexes(const size_t position, const bool isRemoval);
+            void rebuildIndexes();
+            const KeyIndex& getIndex(const JSONPointer& keyPath) const;
+            const std::vector<JSONObject>& packedElements() const;
+
+            std::variant<std::vector<JSONObject>, std::vector<JSONIntegral>, std::vector<JSONFloating>> value;
+            std::vector<KeyIndex> indexes;
+            // Filled by packedElements() and shared between concurrent readers with the atomic shared_ptr functions.
+            // Never copied, every non-const member function resets it.
+            mutable std::shared_ptr<const std::vector<JSONObject>> packedElementCache;
     };
 
     class JSONObject {
@@ -161,6 +565,12 @@ namespace simpleJSON {
             JSONObject(const JSONNull n);
             JSONObject(const JSONArray& arr);
             JSONObject(const std::initializer_list<std::pair<const JSONString, JSONObject>> list);
+            JSONObject(const JSONObject& other) = default;
+            JSONObject(JSONObject&& other) = default;
+            JSONObject& operator=(const JSONObject& other) = default;
+            JSONObject& operator=(JSONObject&& other) = default;
+            // Takes nested arrays and maps apart without recursion, so documents of any depth can be destroyed
+            ~JSONObject();
 
             template <typename T>
             void append(T&& arg);
@@ -170,12 +580,38 @@ namespace simpleJSON {
 
             JSONObject& operator[](const size_t index);
             const JSONObject& operator[](const size_t index) const;
+            // Copy of the array element at index, see JSONArray::get
+            JSONObject get(const size_t index) const;
 
             void removeField(const JSONString& key);
             size_t getNumberOfFields() const;
 
             JSONObject& operator[](const JSONString& key);
             const JSONObject& operator[](const JSONString& key) const;
+            JSONObject& operator[](const JSONKey& key);
+            const JSONObject& operator[](const JSONKey& key) const;
+
+            // Lookups that never insert, nullptr when the key is missing
+            const JSONObject* find(std::string_view key) const;
+            const JSONObject* find(const JSONKey& key) const;
+            // Calls func(const JSONString& key, const JSONObject& value) for every field, in key order
+            template <typename F>
+            void forEachField(F&& func) const;
+
+            bool isString() const;
+            bool isNumber() const;
+            bool isBool() const;
+            bool isNull() const;
+            bool isArray() const;
+            bool isMap() const;
+
+            const JSONString& asString() const;
+            const JSONNumber& asNumber() const;
+            const JSONBool& asBool() const;
+            const JSONArray& asArray() const;
+            JSONArray& asArray();
+            const JSONMap& asMap() const;
+            JSONMap& asMap();
 
             friend bool operator==(const JSONObject& lhs, const JSONObject& rhs);
             friend bool operator!=(const JSONObject& lhs, const JSONObject& rhs);
@@ -188,11 +624,524 @@ namespace simpleJSON {
             std::string toIndentedString(std::string& currentIndentation, const std::string& indentString) const;
 
         private:
-            std::variant<JSONString, JSONNumber, JSONBool, JSONNull, JSONArray, std::map<JSONString, JSONObject>> value;
+            // Moves the children of obj that are non-empty arrays or maps to nested
+            static void takeNestedValues(JSONObject& obj, std::vector<JSONObject>& nested);
+
+            std::variant<JSONString, JSONNumber, JSONBool, JSONNull, JSONArray, JSONMap> value;
+    };
+
+    // Outcome of parsing one document of a batch, error holds the exception message when parsing failed
+    struct BatchParseResult {
+        bool success = false;
+        JSONObject value;
+        std::string error;
+    };
+
+    // Parses independent documents on threadCount threads (0 = one per hardware thread).
+    // Results are returned in input order, a failing document does not affect the others.
+    std::vector<BatchParseResult> parseBatch(const std::string_view* documents, const size_t documentCount, const size_t threadCount = 0);
+    std::vector<BatchParseResult> parseBatch(const std::vector<std::string_view>& documents, const size_t threadCount = 0);
+
+    enum class FileReadBackend {
+        AUTO,           // io_uring when the kernel provides it, THREAD_POOL otherwise
+        THREAD_POOL
+    };
+
+    // Reads and parses many files, keeping up to queueDepth reads in flight while threadCount threads
+    // (0 = one per hardware thread) parse the files that have arrived. Results are returned in input order,
+    // a file that cannot be read or parsed only affects its own result.
+    std::vector<BatchParseResult> parseFiles(const std::vector<std::string>& fileNames, const size_t threadCount = 0, 
+                                             const size_t queueDepth = 64, const FileReadBackend backend = FileReadBackend::AUTO);
+
+    enum class DifferenceKind {
+        ADDED,
+        REMOVED,
+        CHANGED
+    };
+
+    // ADDED and REMOVED values exist only in the right or left document, CHANGED values exist in both with a
+    // different type or value. Array elements are matched by position.
+    struct JSONDifference {
+        DifferenceKind kind;
+        JSONPointer path;
+    };
+
+    // Deep comparison, hashing and diffing of large documents. Arrays and objects with many children are split
+    // across threadCount threads (0 = one per hardware thread). Results do not depend on the thread count.
+    bool equalsParallel(const JSONObject& lhs, const JSONObject& rhs, const size_t threadCount = 0);
+    // Equal documents have equal hashes
+    uint64_t structuralHash(const JSONObject& obj, const size_t threadCount = 0);
+    // Differences in document order
+    std::vector<JSONDifference> diff(const JSONObject& lhs, const JSONObject& rhs, const size_t threadCount = 0);
+
+    // Incremental SHA-256 (FIPS 180-4)
+    class SHA256 {
+        public:
+            SHA256();
+
+            void update(std::string_view data);
+            // Digest of everything passed to update since construction or the last reset
+            std::array<uint8_t, 32> finish();
+            void reset();
+
+            static std::string toHex(const std::array<uint8_t, 32>& digest);
+
+        private:
+            void processBlock(const uint8_t* block);
+
+            std::array<uint32_t, 8> state;
+            std::array<uint8_t, 64> buffer;
+            size_t bufferSize;
+            uint64_t totalSize;
+    };
+
+    // RFC 8785 (JCS) canonical form for signing and content addressing: no whitespace, object keys ordered by
+    // their UTF-16 code units, strings re-escaped minimally and numbers written like ECMAScript writes doubles.
+    // A number is written as the double nearest to the value stored in the document, ties to even.
+    // Throws JSONException for numbers that are not finite doubles and for objects with two keys that are equal
+    // once unescaped.
+    std::string dumpToCanonicalString(const JSONObject& obj);
+    // Feeds the canonical form into hash as it is produced, without building the string
+    void hashCanonical(const JSONObject& obj, SHA256& hash);
+    std::array<uint8_t, 32> canonicalSHA256(const JSONObject& obj);
+
+    enum class JSONTokenType {
+        BEGIN_OBJECT,
+        END_OBJECT,
+        BEGIN_ARRAY,
+        END_ARRAY,
+        KEY,
+        STRING,
+        NUMBER,
+        BOOL,
+        NULL_VALUE
+    };
+
+    // text is the token exactly as it appears in the input: string and key contents without the quotes and with
+    // escape sequences kept (like JSONString), the number spelling, true/false/null or the bracket.
+    // It is only valid until the next token is produced.
+    struct JSONToken {
+        JSONTokenType type;
+        std::string_view text;
+    };
+
+    // Resumable, validating push tokenizer. Input may be split into chunks at any byte, tokens that span
+    // chunks are buffered until they are complete. Calls onToken(const JSONToken&) for every token.
+    class JSONTokenizer {
+        public:
+            JSONTokenizer();
+
+            template <typename F>
+            void feed(std::string_view chunk, F&& onToken);
+            // Signals the end of input. Throws if the document is incomplete.
+            template <typename F>
+            void finish(F&& onToken);
+            void reset();
+
+            // True once a whole top level value has been read
+            bool isComplete() const;
+            size_t getDepth() const;
+
+        private:
+            enum class Lexeme { NONE, STRING, NUMBER, LITERAL };
+
+            bool nextToken(std::string_view chunk, size_t& pos, JSONToken& token);
+            JSONToken completeLexeme(std::string_view text);
+
+            internal::JSONSyntaxState__internal syntax;
+            Lexeme lexeme;
+            bool escaped;
+            // where the current lexeme starts, in the current chunk and in the whole input
+            size_t lexemeStart;
+            size_t lexemeOffset;
+            std::string pending;
+            size_t consumed;
+    };
+
+#ifdef SIMPLEJSON_HAS_COROUTINES
+    // Result of JSONStreamParser::parse, resumes the awaiting coroutine once the document is complete
+    class JSONParseTask {
+        public:
+            struct promise_type {
+                std::optional<JSONObject> result;
+                std::exception_ptr error;
+                std::coroutine_handle<> continuation;
+
+                JSONParseTask get_return_object();
+                std::suspend_always initial_suspend() noexcept;
+                auto final_suspend() noexcept;
+                void return_value(JSONObject value);
+                void unhandled_exception();
+            };
+
+            explicit JSONParseTask(std::coroutine_handle<promise_type> handle);
+            JSONParseTask(JSONParseTask&& other) noexcept;
+            JSONParseTask(const JSONParseTask&) = delete;
+            JSONParseTask& operator=(const JSONParseTask&) = delete;
+            ~JSONParseTask();
+
+            bool await_ready() const noexcept;
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept;
+            JSONObject await_resume();
+
+        private:
+            std::coroutine_handle<promise_type> handle;
+    };
+#endif
+
+    // Builds a JSONObject from input that arrives in chunks
+    class JSONStreamParser {
+        public:
+            JSONStreamParser();
+
+            void feed(std::string_view chunk);
+            JSONObject finish();
+            // When set, elements of a top level array are passed to the handler as soon as they are complete
+            // instead of being stored, finish() then returns an empty array
+            void setRecordHandler(std::function<void(JSONObject)> handler);
+
+#ifdef SIMPLEJSON_HAS_COROUTINES
+            // co_await source.next() must produce a std::optional<std::string_view>, std::nullopt at the end of input.
+            // The chunk only has to stay valid until the next call to next().
+            template <typename AsyncSource>
+            JSONParseTask parse(AsyncSource& source);
+#endif
+
+        private:
+            void onToken(const JSONToken& token);
+            void addValue(JSONObject value);
+
+            JSONTokenizer tokenizer;
+            std::vector<JSONObject> containers;
+            std::vector<std::string> keys;
+            JSONObject root;
+            std::function<void(JSONObject)> recordHandler;
+    };
+
+    // Reads the file on a separate thread in blocks of blockSize bytes, with blockCount blocks in flight,
+    // while the calling thread parses the blocks that have already arrived
+    JSONObject parseFromFilePipelined(const char* fileName, const size_t blockSize = 1 << 20, const size_t blockCount = 3);
+    // Pipelined like parseFromFilePipelined, but every element of the top level array is passed to onRecord(JSONObject&)
+    // on a third thread as soon as it has been parsed, so the whole document is never held in memory.
+    // A top level value that is not an array is passed as a single record.
+    template <typename F>
+    void forEachRecordInFile(const char* fileName, F&& onRecord, const size_t blockSize = 1 << 20, const size_t blockCount = 3);
+
+    // Writes JSON straight to a string, stream or file descriptor without building a JSONObject tree.
+    // With an empty indentString the output matches dumpToString, otherwise it matches dumpToPrettyString.
+    // Strings and keys passed as text are escaped, JSONString and JSONObject values are written as stored.
+    // Unless NDEBUG is defined, calls that would produce invalid JSON throw JSONException.
+    class JSONWriter {
+        public:
+            explicit JSONWriter(std::string& out, const std::string& indentString = "");
+            explicit JSONWriter(std::ostream& out, const std::string& indentString = "");
+#ifdef SIMPLEJSON_HAS_MMAP
+            explicit JSONWriter(const int fd, const std::string& indentString = "");
+#endif
+            JSONWriter(const JSONWriter&) = delete;
+            JSONWriter& operator=(const JSONWriter&) = delete;
+            ~JSONWriter();
+
+            JSONWriter& startObject();
+            JSONWriter& endObject();
+            JSONWriter& startArray();
+            JSONWriter& endArray();
+            JSONWriter& key(std::string_view name);
+
+            JSONWriter& value(std::string_view str);
+            JSONWriter& value(const char* str);
+            JSONWriter& value(const std::string& str);
+            JSONWriter& value(const JSONNumber& num);
+            template <typename N, typename = typename std::enable_if_t<std::is_arithmetic_v<N> && !std::is_same_v<N, bool>>>
+            JSONWriter& value(const N num);
+            JSONWriter& value(const bool b);
+            JSONWriter& value(const std::nullptr_t);
+            JSONWriter& value(const JSONObject& obj);
+
+            // Write text that is already valid JSON as is: a key or string contents with escape sequences
+            // (without the quotes), or any complete value
+            JSONWriter& rawKey(std::string_view escapedName);
+            JSONWriter& rawString(std::string_view escapedText);
+            JSONWriter& rawValue(std::string_view json);
+
+            // True once a complete top level value has been written
+            bool isComplete() const;
+            // Writes buffered output to the stream or file descriptor, also done by the destructor.
+            // Throws if the stream is in a failed state afterwards or the file descriptor cannot be written.
+            void flush();
+
+        private:
+            void beforeValue();
+            void beforeEnd(const bool isObject);
+            void writeIndentation();
+            void write(std::string_view text);
+
+            std::string* stringSink;
+            std::ostream* streamSink;
+            int fdSink;
+            std::string buffer;
+            std::string indentString;
+            // one entry per open container, true for objects
+            std::vector<bool> containers;
+            bool hasChildren;
+            bool keyWritten;
+            bool rootWritten;
+    };
+
+    enum class FilterAction {
+        DROP,       // removes the value, together with its key inside objects
+        REPLACE     // writes the replacement instead of the value
+    };
+
+    // Rewrites JSON documents as they stream in, without building them. Values whose location matches a rule
+    // are dropped or replaced, all other tokens are copied to a JSONWriter exactly as written (strings keep their
+    // escape sequences, numbers their spelling). Rule patterns are JSON Pointers in which a "*" token matches
+    // any key or array index, keys are compared after resolving their escape sequences. The first matching rule is applied.
+    class JSONFilter {
+        public:
+            JSONFilter();
+
+            // Throws for the root pattern "", a document cannot be dropped as a whole. Replace it instead.
+            JSONFilter& drop(const JSONPointer& pattern);
+            // Replaces the value with the string mask
+            JSONFilter& redact(const JSONPointer& pattern, std::string_view mask = "[REDACTED]");
+            JSONFilter& replace(const JSONPointer& pattern, const JSONObject& replacement);
+
+            // Input may be split at any byte. Output formatting is decided by the writer.
+            void feed(std::string_view chunk, JSONWriter& writer);
+            // Throws if the document is incomplete
+            void finish(JSONWriter& writer);
+            // Prepares for a new document, rules are kept
+            void reset();
+
+            // Filters a whole document into compact JSON
+            std::string apply(std::string_view input);
+
+        private:
+            struct Rule {
+                std::vector<std::string> tokens;
+                FilterAction action;
+                JSONObject replacement;
+            };
+
+            // childCount is the number of values started so far, so the current child is childCount - 1.
+            // key is kept as written for the output, name is the unescaped key that rules are matched against.
+            struct Frame {
+                bool isArray;
+                size_t childCount;
+                std::string key;
+                std::string name;
+            };
+
+            void onToken(const JSONToken& token, JSONWriter& writer);
+            const Rule* matchCurrentValue() const;
+
+            JSONTokenizer tokenizer;
+            std::vector<Rule> rules;
+            size_t maxRuleDepth;
+            std::vector<Frame> path;
+            // number of containers opened inside a dropped or replaced value
+            size_t skipDepth;
+    };
+
+    // Reformat JSON without building a document. Key order, escape sequences and number spelling are kept
+    // exactly as written and the input is validated on the way, only whitespace changes. The layout is
+    // the same as that of dumpToString and dumpToPrettyString.
+    void minify(std::istream& in, std::ostream& out);
+    void prettify(std::istream& in, std::ostream& out, const std::string& indentString = defaultIndentString);
+    std::string minify(std::string_view json);
+    std::string prettify(std::string_view json, const std::string& indentString = defaultIndentString);
+
+    // Read-only handle to a single value inside a snapshot. Views are cheap to copy and stay valid
+    // for as long as the JSONSnapshot they were obtained from is alive.
+    class JSONSnapshotView {
+        public:
+            JSONSnapshotView(const char* data, const size_t dataSize, const uint64_t nodeOffset);
+
+            bool isString() const;
+            bool isNumber() const;
+            bool isBool() const;
+            bool isNull() const;
+            bool isArray() const;
+            bool isMap() const;
+
+            std::string_view getString() const;
+            JSONNumber getNumber() const;
+            bool getBoolean() const;
+
+            size_t size() const;
+            JSONSnapshotView operator[](const size_t index) const;
+
+            size_t getNumberOfFields() const;
+            bool hasField(std::string_view key) const;
+            JSONSnapshotView operator[](std::string_view key) const;
+            std::string_view getKey(const size_t fieldIndex) const;
+            JSONSnapshotView getValue(const size_t fieldIndex) const;
+
+            JSONObject toJSONObject() const;
+
+        private:
+            uint32_t tag() const;
+            uint32_t count() const;
+            template <typename T>
+            T read(const uint64_t offset) const;
+
+            const char* data;
+            size_t dataSize;
+            uint64_t nodeOffset;
+    };
+
+    // Read-only, constexpr-queryable view of a JSON document that was parsed at compile time (see SIMPLEJSON_STATIC_JSON).
+    // Strings are returned exactly as written in the literal, escape sequences included, like JSONString.
+    class StaticJSONView {
+        public:
+            constexpr StaticJSONView(const internal::StaticJSONNode__internal* nodes, std::string_view text, const size_t nodeIndex);
+
+            constexpr bool isString() const;
+            constexpr bool isNumber() const;
+            constexpr bool isBool() const;
+            constexpr bool isNull() const;
+            constexpr bool isArray() const;
+            constexpr bool isMap() const;
+
+            constexpr std::string_view getString() const;
+            constexpr JSONIntegral getIntegral() const;
+            JSONNumber getNumber() const;
+            constexpr bool getBoolean() const;
+
+            constexpr size_t size() const;
+            constexpr StaticJSONView operator[](const size_t index) const;
+
+            constexpr size_t getNumberOfFields() const;
+            constexpr bool hasField(std::string_view key) const;
+            constexpr StaticJSONView operator[](std::string_view key) const;
+
+            JSONObject toJSONObject() const;
+
+        private:
+            const internal::StaticJSONNode__internal* nodes;
+            std::string_view text;
+            size_t nodeIndex;
+    };
+
+    // A JSON literal validated and flattened at compile time. Invalid JSON fails the build.
+    // Create it with SIMPLEJSON_STATIC_JSON, which computes NodeCount:
+    //
+    //     static constexpr auto config = SIMPLEJSON_STATIC_JSON(R"({"port": 8080})");
+    //     static_assert(config.root()["port"].getIntegral() == 8080);
+    template <size_t NodeCount>
+    class StaticJSON {
+        public:
+            constexpr StaticJSON(std::string_view text);
+
+            constexpr StaticJSONView root() const;
+
+        private:
+            std::string_view text;
+            std::array<internal::StaticJSONNode__internal, NodeCount> nodes;
+    };
+
+    namespace literals {
+        // Runtime parse of a JSON literal, e.g. auto obj = R"({"key": 1})"_json;
+        JSONObject operator""_json(const char* text, size_t length);
+    }   // namespace literals
+
+    // Owns the bytes of a snapshot. When opened from a file the file is memory mapped (where the platform
+    // supports it), so opening is O(1) and pages are shared between processes that open the same file.
+    class JSONSnapshot {
+        public:
+            JSONSnapshot(const char* fileName);
+            JSONSnapshot(std::string snapshotBytes);
+            JSONSnapshot(const JSONSnapshot&) = delete;
+            JSONSnapshot& operator=(const JSONSnapshot&) = delete;
+            JSONSnapshot(JSONSnapshot&& other) noexcept;
+            JSONSnapshot& operator=(JSONSnapshot&& other) noexcept;
+            ~JSONSnapshot();
+
+            JSONSnapshotView root() const;
+
+        private:
+            void validate() const;
+            void release();
+
+            std::string ownedBytes;
+            const char* data;
+            size_t dataSize;
+            bool isMapped;
+    };
+
+    // Buffered output shared by all binary codecs. Values that are only known after their content has been
+    // written (e.g. BSON document lengths) are reserved with a placeholder and back-patched.
+    class BinaryWriter {
+        public:
+            BinaryWriter();
+
+            void writeByte(const uint8_t byte);
+            void writeBytes(const char* bytes, const size_t count);
+            template <typename T>
+            void writeLittleEndian(const T val);
+            template <typename T>
+            void writeBigEndian(const T val);
+            template <typename T>
+            void patchLittleEndian(const size_t position, const T val);
+
+            size_t position() const;
+            std::string release();
+
+        private:
+            std::string buffer;
+    };
+
+    class BinaryReader {
+        public:
+            BinaryReader(std::string_view bytes);
+
+            uint8_t readByte();
+            uint8_t peekByte() const;
+            std::string_view readBytes(const size_t count);
+            template <typename T>
+            T readLittleEndian();
+            template <typename T>
+            T readBigEndian();
+
+            size_t position() const;
+            size_t remaining() const;
+            bool atEnd() const;
+
+        private:
+            void require(const size_t count) const;
+
+            std::string_view bytes;
+            size_t pos;
+    };
+
+    // BSON only has documents at top level, so the encoded JSONObject must be a map.
+    // Integers are stored as int32 when they fit and int64 otherwise, floating point numbers as double.
+    // Decoding rejects documents nested deeper than maxDepth.
+    struct BSONCodec {
+        static constexpr size_t maxDepth = 1024;
+
+        static void encode(BinaryWriter& writer, const JSONObject& obj);
+        static JSONObject decode(BinaryReader& reader);
+    };
+
+    // Arrays whose elements are all integers (or all floating point numbers) are written as strongly typed
+    // UBJSON containers ([$<type>#<count>) so numeric data carries no per-element markers.
+    // Decoding rejects containers nested deeper than maxDepth. Typed arrays of null, true or false carry no bytes
+    // per element, their count may be at most maxEmptyElementsPerByte per remaining input byte (plus one).
+    struct UBJSONCodec {
+        static constexpr size_t maxDepth = 1024;
+        static constexpr size_t maxEmptyElementsPerByte = 16;
+
+        static void encode(BinaryWriter& writer, const JSONObject& obj);
+        static JSONObject decode(BinaryReader& reader);
     };
 
 }   // namespace simpleJSON 
 
+#define SIMPLEJSON_FIELD(Type, member) simpleJSON::bindField(#member, &Type::member)
+#define SIMPLEJSON_STATIC_JSON(text) simpleJSON::StaticJSON<::internal::countStaticJSONNodes__internal(text)>(text)
+
 //------------------------------------- IMPLEMENTATION -------------------------------------
 
 namespace internal {
@@ -222,339 +1171,574 @@ namespace internal {
     simpleJSON::JSONNull parseNull__internal(std::istream& stream);
     simpleJSON::JSONArray parseArray__internal(std::istream& stream);
     simpleJSON::JSONObject parseObject__internal(std::istream& stream);
-} // namespace internal
 
-namespace simpleJSON {
-    JSONObject parseFromFile(const char* fileName) {
-        FUNCTRACE
+    // Snapshot layout: a 16 byte header (magic, root node offset) followed by 8 byte aligned nodes.
+    // Every node starts with a uint32 tag and a uint32 count (string length, element or field count, boolean value).
+    // Arrays are followed by count uint64 element offsets, maps by count (key offset, value offset) pairs sorted by key.
+    enum class SnapshotTag : uint32_t {
+        SNAPSHOT_STRING,
+        SNAPSHOT_INTEGRAL,
+        SNAPSHOT_FLOATING,
+        SNAPSHOT_BOOL,
+        SNAPSHOT_NULL,
+        SNAPSHOT_ARRAY,
+        SNAPSHOT_MAP
+    };
 
-        std::ifstream stream(fileName);
-        return internal::beginParseFromStream__internal(stream);
-    }
+    constexpr char snapshotMagic[8] = {'S', 'J', 'S', 'N', 'A', 'P', '0', '1'};
+    constexpr size_t snapshotHeaderSize = 16;
+    constexpr size_t snapshotNodeHeaderSize = 8;
 
-    JSONObject parseFromString(std::string& jsonString) {
-        FUNCTRACE
+    template <typename T>
+    void appendSnapshotValue__internal(std::string& out, const T& val);
+    uint64_t beginSnapshotNode__internal(std::string& out, const SnapshotTag tag, const uint32_t count);
+    uint64_t writeSnapshotString__internal(std::string& out, const std::string& str);
+    uint64_t writeSnapshotNode__internal(std::string& out, const simpleJSON::JSONObject& obj);
+
+    // JSONString keeps strings exactly as they were written in JSON (escape sequences included),
+    // binary formats carry plain UTF-8 so strings are converted at the boundary
+    std::string unescapeString__internal(const std::string& str);
+    std::string escapeString__internal(std::string_view str);
+    void appendUTF8__internal(std::string& out, const uint32_t codePoint);
+
+    // Aggregation kernels over packed array storage
+    // Running sum behind JSONArray::sum for packed and unpacked storage alike. Integral elements are summed exactly,
+    // floating point elements go to four accumulators in turn that are added up at the end.
+    struct NumberSum__internal {
+        // exact total of the integral elements, upper * 2^32 + lower with lower < 2^32
+        int64_t upper = 0;
+        uint64_t lower = 0;
+        simpleJSON::JSONFloating floatings[4] = {0, 0, 0, 0};
+        size_t floatingCount = 0;
+
+        void addIntegral(const int64_t val);
+        void addIntegrals(const simpleJSON::JSONIntegral* data, const size_t count);
+        void addFloatings(const simpleJSON::JSONFloating* data, const size_t count);
+        void add(const simpleJSON::JSONNumber& num);
+        // Integral if every element was and the total fits into JSONIntegral
+        simpleJSON::JSONNumber result() const;
+    };
+    template <typename T>
+    T minOf__internal(const T* data, const size_t count);
+    template <typename T>
+    T maxOf__internal(const T* data, const size_t count);
+    const simpleJSON::JSONNumber& numberElement__internal(const simpleJSON::JSONObject& elem);
+    void unpackArrays__internal(simpleJSON::JSONObject& obj);
+    using ChildList__internal = std::vector<std::pair<const simpleJSON::JSONString*, const simpleJSON::JSONObject*>>;
+    // Children of an array or map in order, keys are nullptr for array elements. Elements of packed arrays are copied into storage.
+    void collectChildren__internal(const simpleJSON::JSONObject& obj, ChildList__internal& children, std::vector<simpleJSON::JSONObject>& storage);
+    // Containers with fewer children are walked on the calling thread, their children may still be split
+    constexpr size_t parallelMinChildren__internal = 1024;
+    bool isLargeContainer__internal(const simpleJSON::JSONObject& obj);
+    struct ChildRange__internal {
+        size_t begin;
+        size_t end;
+        bool isLarge;
+    };
+    // Splits children into at most a few hundred ranges for parallelFor__internal. Every child flagged in isLarge gets
+    // a range of its own, it is meant to be processed after the others with all threads, so that a big subtree
+    // is split again instead of being left to the one worker that happened to get it.
+    std::vector<ChildRange__internal> splitChildren__internal(const std::vector<char>& isLarge);
+    bool equalsParallel__internal(const simpleJSON::JSONObject& lhs, const simpleJSON::JSONObject& rhs, const size_t threadCount, std::atomic<bool>& mismatch);
+    uint64_t combineHash__internal(const uint64_t seed, const uint64_t value);
+    uint64_t hashParallel__internal(const simpleJSON::JSONObject& obj, const size_t threadCount);
+    void diffParallel__internal(const simpleJSON::JSONObject& lhs, const simpleJSON::JSONObject& rhs, const simpleJSON::JSONPointer& path, 
+                                std::vector<simpleJSON::JSONDifference>& out, const size_t threadCount);
+    // indentString == nullptr produces compact output
+    void dumpParallel__internal(const simpleJSON::JSONObject& obj, std::string& out, std::string& currentIndentation, const std::string* indentString, const size_t threadCount);
+
+    // Flattened compile time document: nodes are stored in pre-order, subtreeEnd is the index one past a node's last
+    // descendant. Map children alternate between a key node and the value subtree.
+    struct StaticJSONNode__internal {
+        NextJsonType type = NextJsonType::JSON_ERROR;
+        bool isFloating = false;
+        size_t begin = 0;
+        size_t end = 0;
+        size_t childCount = 0;
+        size_t subtreeEnd = 0;
+    };
 
-        std::stringstream stream(jsonString);
-        return internal::beginParseFromStream__internal(stream);
-    }
+    // Strict validating parser that runs at compile time. Throwing during constant evaluation is a compile error.
+    // With nodes == nullptr it only counts the nodes the document needs.
+    struct StaticJSONParser__internal {
+        std::string_view text;
+        size_t pos;
+        StaticJSONNode__internal* nodes;
+        size_t nodeCount;
+
+        constexpr void skipWhitespace();
+        constexpr void parseDocument();
+        constexpr size_t parseValue();
+        constexpr void parseString();
+        constexpr bool parseNumber();
+        constexpr void parseLiteral(std::string_view literal);
+        // The error to throw at the current position, never evaluated at compile time
+        simpleJSON::JSONSyntaxError syntaxError(const simpleJSON::JSONSyntaxErrorKind kind) const;
+    };
 
-    // void dumpToFile(const char* fileName);
+    constexpr size_t countStaticJSONNodes__internal(std::string_view text);
+    std::string syntaxErrorMessage__internal(const simpleJSON::JSONSyntaxErrorKind kind, const size_t offset, const char* source);
+    // The runtime parsers validate strings and numbers with the StaticJSONParser__internal grammar. The lexeme
+    // starts at pos in text, text starts at textOffset in the whole input. Return the position after the lexeme,
+    // errors are thrown as JSONSyntaxError of the runtime parser with offsets into the whole input.
+    size_t validateString__internal(std::string_view text, const size_t pos, const size_t textOffset);
+    // Also rejects a number that is directly followed by more number characters, like 01 or 1.2.3
+    size_t validateNumber__internal(std::string_view text, const size_t pos, const size_t textOffset);
+    void validateLiteral__internal(std::string_view literal, const size_t offset);
+
+    // FNV-1a, usable at compile time so that bound field names are hashed once, by the compiler
+    constexpr uint64_t hashKey__internal(std::string_view key);
+
+    // Blocking queue with a fixed capacity used between pipeline stages. After close() pushes fail and
+    // pops drain the remaining items.
+    template <typename T>
+    class BoundedQueue__internal {
+        public:
+            explicit BoundedQueue__internal(const size_t capacity);
 
-    std::string dumpToString(const JSONObject& obj) {
-        return obj.toString();
-    }
+            bool push(T item);
+            bool pop(T& item);
+            void close();
 
-    std::string dumpToPrettyString(const JSONObject& obj, const std::string& indentString) {
-        std::string currentIndentation = "";
-        return obj.toIndentedString(currentIndentation, indentString);
-    }
+        private:
+            std::mutex mutex;
+            std::condition_variable notFull;
+            std::condition_variable notEmpty;
+            std::deque<T> items;
+            size_t capacity;
+            bool closed;
+    };
 
-    // JSONexception
+    void readBlocks__internal(const char* fileName, const size_t blockSize, BoundedQueue__internal<std::string>& freeBlocks, 
+                              BoundedQueue__internal<std::string>& filledBlocks, std::exception_ptr& error);
+    simpleJSON::JSONObject parsePipelined__internal(const char* fileName, const size_t blockSize, const size_t blockCount, simpleJSON::JSONStreamParser& parser);
 
-    JSONException::JSONException(const char* msg) : message(msg) {}
+    // Writes documents with an explicit stack instead of recursing. Without options the output is compact,
+    // otherwise indentation is copied out of a table that grows to the deepest level seen so far.
+    // Output is std::string or LengthCounter__internal, which only counts the bytes that would be written.
+    template <typename Output>
+    class DocumentPrinter__internal {
+        public:
+            DocumentPrinter__internal(Output& out, const simpleJSON::PrettyPrintOptions* options, std::string_view baseIndentation);
 
-    const char* JSONException::what () const throw () {
-        return message;
-    }
+            void print(const simpleJSON::JSONObject& obj);
+            void print(const simpleJSON::JSONArray& arr);
 
-    // JSONString
+        private:
+            // arrays are walked by index, objects by iterator
+            struct Frame {
+                const simpleJSON::JSONArray* array;
+                size_t index;
+                simpleJSON::JSONMap::const_iterator field;
+                simpleJSON::JSONMap::const_iterator fieldsEnd;
+            };
+
+            void beginValue(const simpleJSON::JSONObject& obj);
+            void beginArray(const simpleJSON::JSONArray& arr);
+            void writeScalar(const simpleJSON::JSONObject& obj);
+            void writeSeparator(const bool first, const size_t depth);
+            void writeClosing(const char bracket, const size_t depth);
+            void writeIndentation(const size_t depth);
+            void run();
+
+            Output& out;
+            const simpleJSON::PrettyPrintOptions* options;
+            std::string indentTable;
+            size_t baseIndentationLength;
+            std::vector<Frame> stack;
+    };
 
-    bool operator==(const JSONString& lhs, const JSONString& rhs) { 
-        return lhs.value == rhs.value;
-    }
+    struct LengthCounter__internal {
+        size_t length = 0;
 
-    bool operator!=(const JSONString& lhs, const JSONString& rhs) { 
-        return !(lhs == rhs);
-    }
+        LengthCounter__internal& operator+=(const char c);
+        LengthCounter__internal& operator+=(std::string_view text);
+        void append(const char* text, const size_t count);
+    };
 
-    bool operator<(const JSONString& lhs, const JSONString& rhs) { 
-        return lhs.value < rhs.value;
-    }
+    // Formats num like JSONNumber::toString and returns the full length, which is larger than bufferSize
+    // (and the buffer incomplete) only for huge floating point values
+    size_t formatNumber__internal(const simpleJSON::JSONNumber& num, char* buffer, const size_t bufferSize);
+    void appendNumber__internal(std::string& out, const simpleJSON::JSONNumber& num);
+    void appendNumber__internal(LengthCounter__internal& out, const simpleJSON::JSONNumber& num);
+
+    template <typename Output>
+    void writeCanonical__internal(Output& out, const simpleJSON::JSONObject& obj);
+    // The double a number is written as in canonical form: the one nearest to the stored value, ties to even.
+    // Wider integral and floating point types are rounded once, from the value as stored, never re-parsed.
+    double canonicalDouble__internal(const simpleJSON::JSONNumber& num);
+    // Formats value like ECMAScript Number.prototype.toString, buffer must hold at least 32 characters
+    size_t formatCanonicalNumber__internal(const double value, char* buffer);
+    std::string canonicalString__internal(const std::string& raw);
+    // Orders UTF-8 strings by their UTF-16 code units
+    bool utf16Less__internal(std::string_view lhs, std::string_view rhs);
+
+    struct SHA256Sink__internal {
+        simpleJSON::SHA256& hash;
+
+        SHA256Sink__internal& operator+=(const char c);
+        SHA256Sink__internal& operator+=(std::string_view text);
+    };
 
-    bool operator<=(const JSONString& lhs, const JSONString& rhs) { 
-        return (lhs < rhs) || (lhs == rhs);
-    }
+    // Position of the first byte at or after pos that is not JSON whitespace, or text.size()
+    size_t skipWhitespace__internal(std::string_view text, size_t pos);
+    // Position of the first '"' or '\\' at or after pos, or text.size()
+    size_t findQuoteOrBackslash__internal(std::string_view text, size_t pos);
+    // Same as findQuoteOrBackslash__internal, also stopping at control characters
+    size_t findStringSpecial__internal(std::string_view text, size_t pos);
+    // Minifies a whole document in one pass: it is validated like JSONTokenizer validates it and everything between
+    // two whitespace runs is copied with a single append.
+    void minifyDocument__internal(std::string_view json, std::string& out);
+    void writeToken__internal(simpleJSON::JSONWriter& writer, const simpleJSON::JSONToken& token);
+    void reformat__internal(std::istream& in, simpleJSON::JSONWriter& writer);
+    void reformat__internal(std::string_view json, simpleJSON::JSONWriter& writer);
+
+    // Read-only stream buffer over memory the caller keeps alive, lets the stream parser run without copying input
+    class MemoryStreamBuffer__internal : public std::streambuf {
+        public:
+            explicit MemoryStreamBuffer__internal(std::string_view data);
 
-    bool operator>(const JSONString& lhs, const JSONString& rhs) { 
-        return lhs.value > rhs.value;
-    }
+            void reset(std::string_view data);
+    };
 
-    bool operator>=(const JSONString& lhs, const JSONString& rhs) { 
-        return (lhs > rhs) || (lhs == rhs);
-    }
+    void parseBatchDocument__internal(MemoryStreamBuffer__internal& buffer, std::istream& stream, std::string_view document, simpleJSON::BatchParseResult& result);
+    bool readWholeFile__internal(const char* fileName, std::string& content, std::string& error);
+    void parseFilesWithThreadPool__internal(const std::vector<std::string>& fileNames, const size_t threadCount, std::vector<simpleJSON::BatchParseResult>& results);
 
-    JSONString::JSONString() : value(std::string{}) { FUNCTRACE }
-    JSONString::JSONString(const char* str) : value(std::string(str)) { FUNCTRACE }
-    JSONString::JSONString(const std::string& str) : value(str) { FUNCTRACE }
+#ifdef SIMPLEJSON_HAS_IO_URING
+    // Minimal io_uring instance driven through raw syscalls, only ever used from a single thread
+    class IoUring__internal {
+        public:
+            IoUring__internal();
+            ~IoUring__internal();
+            IoUring__internal(const IoUring__internal&) = delete;
+            IoUring__internal& operator=(const IoUring__internal&) = delete;
+
+            // false when the kernel does not support io_uring or refuses to create one
+            bool setup(const unsigned entries);
+            // Submits what is pending first if every entry of the submission ring is in use
+            io_uring_sqe* nextSubmission();
+            void submitAndWait(const unsigned minComplete);
+            bool popCompletion(uint64_t& userData, int& result);
 
-    std::string JSONString::getString() const {
-        return value;
-    }
+        private:
+            int ringFd;
+            unsigned pendingSubmissions;
+            void* submissionRing;
+            size_t submissionRingSize;
+            void* completionRing;
+            size_t completionRingSize;
+            io_uring_sqe* submissionEntries;
+            size_t submissionEntriesSize;
+            unsigned* submissionHead;
+            unsigned* submissionTail;
+            unsigned submissionCapacity;
+            unsigned* submissionMask;
+            unsigned* submissionArray;
+            unsigned* completionHead;
+            unsigned* completionTail;
+            unsigned* completionMask;
+            io_uring_cqe* completionEntries;
+    };
 
-    std::string JSONString::toString() const {
-        return "\"" + value + "\"";
-    }
+    struct FileReadSlot__internal {
+        size_t fileIndex = 0;
+        int fd = -1;
+        size_t bytesRead = 0;
+        std::string buffer;
+    };
 
-    // JSONNumber
+    void readFilesWithIoUring__internal(IoUring__internal& ring, const std::vector<std::string>& fileNames, const size_t queueDepth, 
+                                        BoundedQueue__internal<std::pair<size_t, std::string>>& loadedFiles, std::vector<simpleJSON::BatchParseResult>& results);
+    bool parseFilesWithIoUring__internal(const std::vector<std::string>& fileNames, const size_t threadCount, const size_t queueDepth, 
+                                         std::vector<simpleJSON::BatchParseResult>& results);
+#endif
 
-    JSONNumber::JSONNumber() : value(JSONIntegral(0)) { FUNCTRACE }
-    
-    template <typename N, typename>
-    JSONNumber::JSONNumber(const N& num) {
-        FUNCTRACE 
+    // Cursor over an in-memory JSON document used by the struct binding parser
+    class StructReader__internal {
+        public:
+            StructReader__internal(std::string_view input);
+
+            char peekNextNonSpaceCharacter();
+            void expect(const char c);
+            bool consumeIf(const char c);
+            std::string_view readRawString();
+            std::string_view readNumberToken();
+            bool readBool();
+            bool readNullIfPresent();
+            void skipValue();
+            void expectEnd();
+            [[noreturn]] void fail(const std::string& message) const;
 
-        if constexpr (std::is_floating_point_v<N>) {
-			value = JSONFloating(num);
-		}
-		else if constexpr (std::is_integral_v<N>) {
-			value = JSONIntegral(num);
-		}
-        else {
-            throw JSONException("JSONNumber must be created with floating point or integral value");
-        }
-    }
+        private:
+            std::string_view input;
+            size_t pos;
+    };
 
-    bool operator==(const JSONNumber& lhs, const JSONNumber& rhs) {
-        return lhs.value == rhs.value;
-    }
+    template <typename T, typename = void>
+    struct IsBoundStruct__internal : std::false_type {};
+    template <typename T>
+    struct IsBoundStruct__internal<T, std::void_t<decltype(simpleJSON::JSONBinding<T>::fields)>> : std::true_type {};
+    template <typename T>
+    struct IsVector__internal : std::false_type {};
+    template <typename T, typename A>
+    struct IsVector__internal<std::vector<T, A>> : std::true_type {};
+    template <typename T>
+    struct IsOptional__internal : std::false_type {};
+    template <typename T>
+    struct IsOptional__internal<std::optional<T>> : std::true_type {};
 
-    bool operator!=(const JSONNumber& lhs, const JSONNumber& rhs) {
-        return !(lhs == rhs);
-    }
+    template <typename T>
+    void readStructValue__internal(StructReader__internal& reader, T& out);
+    template <typename T>
+    void writeStructValue__internal(std::string& out, const T& val);
 
-    bool operator<(const JSONNumber& lhs, const JSONNumber& rhs) {
-        // FIXME: find a better way to implement this method!!!
-        // std::variant::operator< and operator > do not behave the way we need
-        auto& lhsValue = lhs.value;
-        auto& rhsValue = rhs.value;
+    // Threads shared by every parallel operation of the process, started on first use and kept until exit.
+    // run() executes work on the calling thread and on up to helperCount idle pool threads at once, and returns
+    // when all of them are done. Threads that are busy elsewhere are not waited for, the caller's own call of
+    // work has to finish the job alone if needed, so nested and concurrent runs cannot deadlock. work must not throw.
+    class WorkerPool__internal {
+        public:
+            static WorkerPool__internal& shared();
+            ~WorkerPool__internal();
 
-        if (std::holds_alternative<JSONFloating>(lhsValue) && std::holds_alternative<JSONFloating>(rhsValue)) { 
-            return std::get<JSONFloating>(lhsValue) < std::get<JSONFloating>(rhsValue);
-        }
-        else if (std::holds_alternative<JSONFloating>(lhsValue) && std::holds_alternative<JSONIntegral>(rhsValue)) { 
-            return std::get<JSONFloating>(lhsValue) < std::get<JSONIntegral>(rhsValue);
-        }
-        else if (std::holds_alternative<JSONIntegral>(lhsValue) && std::holds_alternative<JSONFloating>(rhsValue)) { 
-            return std::get<JSONIntegral>(lhsValue) < std::get<JSONFloating>(rhsValue);
-        }
-        else if (std::holds_alternative<JSONIntegral>(lhsValue) && std::holds_alternative<JSONIntegral>(rhsValue)) { 
-            return std::get<JSONIntegral>(lhsValue) < std::get<JSONIntegral>(rhsValue);
-        }
-        else {
-            // should not get here
-            throw JSONException("Unexpected comparison on JSONNumber");
-        }
-    }
+            void run(const std::function<void()>& work, const size_t helperCount);
 
-    bool operator<=(const JSONNumber& lhs, const JSONNumber& rhs) {
-        return (lhs < rhs) || (lhs == rhs);
-    }
+        private:
+            struct Job {
+                const std::function<void()>* work;
+                size_t wanted;
+                size_t active;
+            };
+
+            WorkerPool__internal() = default;
+            void workerLoop();
+
+            std::mutex mutex;
+            std::condition_variable jobAvailable;
+            std::condition_variable helpersDone;
+            std::deque<Job*> jobs;
+            std::vector<std::thread> threads;
+            bool stopping = false;
+    };
 
-    bool operator>(const JSONNumber& lhs, const JSONNumber& rhs) {
-        // FIXME: find a better way to implement this method!!!
-        // std::variant::operator< and operator > do not behave the way we need
-        auto& lhsValue = lhs.value;
-        auto& rhsValue = rhs.value;
-        
-        if (std::holds_alternative<JSONFloating>(lhsValue) && std::holds_alternative<JSONFloating>(rhsValue)) { 
-            return std::get<JSONFloating>(lhsValue) > std::get<JSONFloating>(rhsValue);
-        }
-        else if (std::holds_alternative<JSONFloating>(lhsValue) && std::holds_alternative<JSONIntegral>(rhsValue)) { 
-            return std::get<JSONFloating>(lhsValue) > std::get<JSONIntegral>(rhsValue);
-        }
-        else if (std::holds_alternative<JSONIntegral>(lhsValue) && std::holds_alternative<JSONFloating>(rhsValue)) { 
-            return std::get<JSONIntegral>(lhsValue) > std::get<JSONFloating>(rhsValue);
-        }
-        else if (std::holds_alternative<JSONIntegral>(lhsValue) && std::holds_alternative<JSONIntegral>(rhsValue)) { 
-            return std::get<JSONIntegral>(lhsValue) > std::get<JSONIntegral>(rhsValue);
-        }
-        else {
-            // should not get here
-            throw JSONException("Unexpected comparison on JSONNumber");
-        }
-    }
+    // Runs task(i) for every i in [0, taskCount) on up to threadCount threads (0 means one per hardware thread),
+    // the calling thread and threads of the shared WorkerPool__internal.
+    // The first exception thrown by a task is rethrown on the calling thread.
+    template <typename F>
+    void parallelFor__internal(const size_t taskCount, size_t threadCount, F&& task);
+    template <typename T, typename Compare>
+    void parallelStableSort__internal(std::vector<T>& items, Compare comp, const size_t threadCount);
+
+    void encodeBSONDocument__internal(simpleJSON::BinaryWriter& writer, const simpleJSON::JSONObject& obj);
+    void encodeBSONElement__internal(simpleJSON::BinaryWriter& writer, const std::string& key, const simpleJSON::JSONObject& obj);
+    simpleJSON::JSONObject decodeBSONDocument__internal(simpleJSON::BinaryReader& reader, const bool isArray, const size_t depth);
+
+    void encodeUBJSONValue__internal(simpleJSON::BinaryWriter& writer, const simpleJSON::JSONObject& obj);
+    char smallestUBJSONIntegerMarker__internal(const simpleJSON::JSONIntegral minVal, const simpleJSON::JSONIntegral maxVal);
+    void encodeUBJSONInteger__internal(simpleJSON::BinaryWriter& writer, const char marker, const simpleJSON::JSONIntegral val);
+    void encodeUBJSONString__internal(simpleJSON::BinaryWriter& writer, const std::string& str);
+    simpleJSON::JSONObject decodeUBJSONValue__internal(simpleJSON::BinaryReader& reader, char marker, const size_t depth);
+    simpleJSON::JSONIntegral decodeUBJSONInteger__internal(simpleJSON::BinaryReader& reader, const char marker);
+    std::string decodeUBJSONString__internal(simpleJSON::BinaryReader& reader);
+
+    // Only defined for the traits the code was compiled with. Users of the compiled library call it during static
+    // initialization, so the reference cannot be optimized away and a library built with other traits fails to link.
+    void libraryCompiledWithSameTraits__internal(const simpleJSON::JSONTraits*);
+
+#if !SIMPLEJSON_DEFINE_NON_TEMPLATES
+    [[maybe_unused]] static const bool libraryTraitsChecked__internal = (libraryCompiledWithSameTraits__internal(nullptr), true);
+#endif
+} // namespace internal
 
-    bool operator>=(const JSONNumber& lhs, const JSONNumber& rhs) {
-        return (lhs > rhs) || (lhs == rhs);
+namespace simpleJSON {
+    template <typename Codec>
+    std::string dumpToBinary(const JSONObject& obj) {
+        FUNCTRACE
+
+        BinaryWriter writer;
+        Codec::encode(writer, obj);
+        return writer.release();
     }
 
-    JSONFloating JSONNumber::getFloating() const {
-        if (std::holds_alternative<JSONFloating>(value)) {
-            return std::get<JSONFloating>(value);
-        }
-        else {
-            throw JSONException("This JSONNumber does not contain a floating point value");
+    template <typename Codec>
+    JSONObject parseFromBinary(std::string_view bytes) {
+        FUNCTRACE
+
+        BinaryReader reader(bytes);
+        JSONObject result = Codec::decode(reader);
+
+        if (!reader.atEnd()) {
+            throw JSONException("Error after reading a valid binary object. Expected end of input");
         }
+
+        return result;
     }
 
-    JSONIntegral JSONNumber::getIntegral() const {
-        if (std::holds_alternative<JSONIntegral>(value)) {
-            return std::get<JSONIntegral>(value);
-        }
-        else {
-            throw JSONException("This JSONNumber does not contain a signed integral value");
-        }
+    template <typename Class, typename Member>
+    constexpr JSONField<Class, Member> bindField(std::string_view name, Member Class::* member) {
+        return JSONField<Class, Member>{name, internal::hashKey__internal(name), member};
     }
 
-    std::string JSONNumber::toString() const {
-        std::string res;
+    template <typename T>
+    T parseStructFromString(std::string_view jsonString) {
+        FUNCTRACE
 
-        auto toStringLambda = [&](auto&& arg) {
-            res += std::to_string(arg);
-        };
-        
-        std::visit(toStringLambda, value);
+        T result{};
+        internal::StructReader__internal reader(jsonString);
+        internal::readStructValue__internal(reader, result);
+        reader.expectEnd();
 
-        return res;
+        return result;
     }
 
-    // JSONBool
+    template <typename T>
+    T parseStructFromFile(const char* fileName) {
+        FUNCTRACE
 
-    JSONBool::JSONBool() : value(false) { FUNCTRACE }
-    JSONBool::JSONBool(bool val) : value(val) { FUNCTRACE }
+        std::ifstream stream(fileName, std::ios::binary);
 
-    bool operator==(const JSONBool& lhs, const JSONBool& rhs) {
-        return lhs.value == rhs.value;
-    }
+        if (!stream) {
+            throw JSONException("Error while opening file for struct parsing");
+        }
 
-    bool operator!=(const JSONBool& lhs, const JSONBool& rhs) {
-        return !(lhs == rhs);
+        std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        return parseStructFromString<T>(contents);
     }
 
-    bool JSONBool::getBoolean() const {
-        return value;
-    }
+    template <typename T>
+    std::string dumpStructToString(const T& val) {
+        FUNCTRACE
 
-    std::string JSONBool::toString() const {
-        return value ? std::string("true") : std::string("false");
+        std::string result;
+        internal::writeStructValue__internal(result, val);
+        return result;
     }
 
-    // JSONNull
-
-    JSONNull::JSONNull() {};
-    
-    JSONNull::JSONNull(const std::nullptr_t) {}
+    // JSONKey
 
-    bool operator==(const JSONNull&, const JSONNull&) {
-        return true;
-    }
+    constexpr JSONKey::JSONKey(std::string_view name) : name(name), hash(internal::hashKey__internal(name)) {}
 
-    bool operator!=(const JSONNull&, const JSONNull&) {
-        return false;
+    constexpr bool operator==(const JSONKey& lhs, const JSONKey& rhs) {
+        return lhs.hash == rhs.hash && lhs.name == rhs.name;
     }
 
-    std::string JSONNull::toString() const {
-        return std::string("null");
+    constexpr bool operator!=(const JSONKey& lhs, const JSONKey& rhs) {
+        return !(lhs == rhs);
     }
 
-    // JSONArray
+    namespace literals {
+        constexpr JSONKey operator""_k(const char* name, size_t length) {
+            return JSONKey(std::string_view(name, length));
+        }
+    }   // namespace literals
 
-    JSONArray::JSONArray() : value(std::vector<JSONObject>{}) { FUNCTRACE }
-    JSONArray::JSONArray(const std::initializer_list<JSONObject> list) : value(list) { FUNCTRACE }
+    // JSONKeyLess
 
-    template <typename T>
-    void JSONArray::append(T&& arg) {
-        FUNCTRACE
-        value.emplace_back(std::forward<T>(arg));
-        return;
+    template <typename K>
+    bool JSONKeyLess::operator()(const JSONString& lhs, const K& rhs) const {
+        return std::string_view(lhs.value) < keyView(rhs);
     }
 
-    void JSONArray::pop() {
-        FUNCTRACE
-        value.pop_back();
-        return;
+    template <typename K>
+    bool JSONKeyLess::operator()(const K& lhs, const JSONString& rhs) const {
+        return keyView(lhs) < std::string_view(rhs.value);
     }
 
-    JSONObject& JSONArray::operator[](const size_t index) {
-        if (index >= value.size()) {
-            throw JSONException("JSONArray operator[] index out of range");
+    template <typename K>
+    std::string_view JSONKeyLess::keyView(const K& key) {
+        if constexpr (std::is_same_v<K, JSONKey>) {
+            return key.name;
         }
         else {
-            return value[index];
+            return std::string_view(key);
         }
     }
 
-    const JSONObject& JSONArray::operator[](const size_t index) const {
-        if (index >= value.size()) {
-            throw JSONException("JSONArray operator[] index out of range");
-        }
+    // JSONNumber
+
+    template <typename N, typename>
+    JSONNumber::JSONNumber(const N& num) {
+        FUNCTRACE 
+
+        if constexpr (std::is_floating_point_v<N>) {
+			value = JSONFloating(num);
+		}
+		else if constexpr (std::is_integral_v<N>) {
+			value = JSONIntegral(num);
+		}
         else {
-            return value.at(index);
+            throw JSONException("JSONNumber must be created with floating point or integral value");
         }
     }
 
-    bool operator==(const JSONArray& lhs, const JSONArray& rhs) {
-        return lhs.value == rhs.value;
-    }
+    // JSONArray
 
-    bool operator!=(const JSONArray& lhs, const JSONArray& rhs) {
-        return !(lhs == rhs);
-    }
+    template <typename T>
+    void JSONArray::append(T&& arg) {
+        FUNCTRACE
 
-    size_t JSONArray::size() const {
-        return value.size();
-    }
-    
-    void JSONArray::clear() {
-        value.clear();
-        return;
-    }
+        using ArgType = std::decay_t<T>;
 
-    std::string JSONArray::toString() const {
-        if (size() == 0) {
-            return "[]";
+        if constexpr ((std::is_integral_v<ArgType> && !std::is_same_v<ArgType, bool>) || std::is_floating_point_v<ArgType>) {
+            appendNumber(JSONNumber(arg));
         }
-        else {
-            std::string res = "[";
-         
-            for(auto& elem : value) {
-                res += elem.toString() + ",";
+        else if constexpr (std::is_same_v<ArgType, JSONNumber>) {
+            appendNumber(arg);
+        }
+        else if constexpr (std::is_same_v<ArgType, JSONObject>) {
+            if (arg.isNumber()) {
+                appendNumber(arg.asNumber());
             }
+            else {
+                unpack();
+                std::get<std::vector<JSONObject>>(value).emplace_back(std::forward<T>(arg));
+            }
+        }
+        else {
+            unpack();
+            std::get<std::vector<JSONObject>>(value).emplace_back(std::forward<T>(arg));
+        }
 
-            res.back() = ']';
-
-            return res;
+        if (!indexes.empty()) {
+            updateIndexes(size() - 1, false);
         }
+        return;
     }
 
-    std::string JSONArray::toIndentedString(std::string& currentIndentation, const std::string& indentString) const {
-        if (size() == 0) {
-            return "[]";
+    template <typename F>
+    void JSONArray::forEach(F&& func) const {
+        forEachInRange(0, size(), std::forward<F>(func));
+        return;
+    }
+
+    template <typename F>
+    void JSONArray::forEachInRange(const size_t begin, const size_t end, F&& func) const {
+        if (std::holds_alternative<std::vector<JSONIntegral>>(value)) {
+            auto& nums = std::get<std::vector<JSONIntegral>>(value);
+            for (size_t i = begin; i < end; ++i) {
+                func(JSONObject(nums[i]));
+            }
+        }
+        else if (std::holds_alternative<std::vector<JSONFloating>>(value)) {
+            auto& nums = std::get<std::vector<JSONFloating>>(value);
+            for (size_t i = begin; i < end; ++i) {
+                func(JSONObject(nums[i]));
+            }
         }
         else {
-            std::string res = "[\n";
-
-            currentIndentation += indentString;
-
-            for (auto& elem : value) {
-                res += currentIndentation + elem.toIndentedString(currentIndentation, indentString) + ",\n";
+            auto& elems = std::get<std::vector<JSONObject>>(value);
+            for (size_t i = begin; i < end; ++i) {
+                func(elems[i]);
             }
-
-            currentIndentation.erase(currentIndentation.length() - indentString.length());
-
-            res.erase(res.length() - 2);
-            res += "\n" + currentIndentation + "]";
-
-            return res;
         }
+        return;
     }
 
     // JSONObject
 
-    JSONObject::JSONObject() : value(std::map<JSONString, JSONObject>{}) { FUNCTRACE }
-    JSONObject::JSONObject(const char* str) : value(JSONString(str)) { FUNCTRACE }
-    JSONObject::JSONObject(const std::string& str) : value(JSONString(str)) { FUNCTRACE }
-    JSONObject::JSONObject(const JSONString& str) : value(str) { FUNCTRACE }
     template <typename N, typename>
     JSONObject::JSONObject(const N& num) : value(JSONNumber(num)) { FUNCTRACE }
-    JSONObject::JSONObject(const JSONNumber& num) : value(num) { FUNCTRACE }
-    JSONObject::JSONObject(const bool b) : value(JSONBool(b)) { FUNCTRACE }
-    JSONObject::JSONObject(const JSONBool b) : value(b) { FUNCTRACE }
-    JSONObject::JSONObject(const std::nullptr_t) : value(JSONNull{}) { FUNCTRACE }
-    JSONObject::JSONObject(const JSONNull n) : value(n) { FUNCTRACE }
-    JSONObject::JSONObject(const JSONArray& arr) : value(arr) { FUNCTRACE }
-    JSONObject::JSONObject(const std::initializer_list<std::pair<const JSONString, JSONObject>> list) : value(list) { FUNCTRACE }
 
     template <typename T>
     void JSONObject::append(T&& arg) {
@@ -568,642 +1752,7174 @@ namespace simpleJSON {
         return;
     }
 
-    void JSONObject::pop() {
-        if (std::holds_alternative<JSONArray>(value)) {
-            auto& arr = std::get<JSONArray>(value);
-            arr.pop();
-            return;
-        }
-        else {
-            throw JSONException("Cannot pop. Current JSONObject does not hold an array");
+    template <typename F>
+    void JSONObject::forEachField(F&& func) const {
+        for (const auto& [key, val] : asMap()) {
+            func(key, val);
         }
+        return;
     }
 
-    JSONObject& JSONObject::operator[](const size_t index) {
-        if (std::holds_alternative<JSONArray>(value)) {
-            auto& arr = std::get<JSONArray>(value);
-            return arr[index];
-        }
-        else {
-            throw JSONException("Operator[] failed, this JSONObject is not an array");
+    // JSONTokenizer
+
+    template <typename F>
+    void JSONTokenizer::feed(std::string_view chunk, F&& onToken) {
+        size_t pos = 0;
+        lexemeStart = 0;
+        JSONToken token;
+
+        while (nextToken(chunk, pos, token)) {
+            onToken(token);
         }
+
+        consumed += chunk.size();
+        return;
     }
 
-    const JSONObject& JSONObject::operator[](const size_t index) const {
-        if (std::holds_alternative<JSONArray>(value)) {
-            auto& arr = std::get<JSONArray>(value);
-            return arr[index];
+    template <typename F>
+    void JSONTokenizer::finish(F&& onToken) {
+        if (lexeme == Lexeme::STRING) {
+            // reports the first problem in the string, at the latest its missing end
+            internal::validateString__internal(pending, 0, lexemeOffset);
+            throw JSONSyntaxError(JSONSyntaxErrorKind::UNTERMINATED_STRING, consumed);
         }
-        else {
-            throw JSONException("Operator[] failed, this JSONObject is not an array");
+        else if (lexeme != Lexeme::NONE) {
+            std::string text = std::move(pending);
+            pending.clear();
+            onToken(completeLexeme(text));
         }
+
+        syntax.finish(consumed);
+        return;
     }
 
-    size_t JSONObject::size() const {
-        if (std::holds_alternative<JSONArray>(value)) {
-            auto& arr = std::get<JSONArray>(value);
-            return arr.size();
-        }
-        else {
-            throw JSONException("Current JSONObject is not an array, cannot call size()");
-        }
+#ifdef SIMPLEJSON_HAS_COROUTINES
+    // JSONParseTask
+    // Everything is inline here: whether coroutines are available depends on the consumer's language mode,
+    // a compiled library built as C++17 could not provide these definitions.
+
+    inline auto JSONParseTask::promise_type::final_suspend() noexcept {
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> finished) noexcept {
+                auto continuation = finished.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+
+        return FinalAwaiter{};
     }
-    
-    void JSONObject::clear() {
-        if (std::holds_alternative<JSONArray>(value)) {
-            auto& arr = std::get<JSONArray>(value);
-            return arr.clear();
-        }
-        else {
-            throw JSONException("Current JSONObject is not an array, cannot call clear()");
-        }
+
+    inline JSONParseTask JSONParseTask::promise_type::get_return_object() {
+        return JSONParseTask(std::coroutine_handle<promise_type>::from_promise(*this));
     }
 
-    void JSONObject::removeField(const JSONString& key) {
-        if (std::holds_alternative<std::map<JSONString, JSONObject>>(value)) {
-            auto& map = std::get<std::map<JSONString, JSONObject>>(value);
+    inline std::suspend_always JSONParseTask::promise_type::initial_suspend() noexcept {
+        return {};
+    }
 
-            auto it = map.find(key);
-            if (it != std::end(map)) {
-                map.erase(it);
-            }
-        }
-        else {
-            throw JSONException("Removing field failed, this JSONObject is not a map");
-        }
+    inline void JSONParseTask::promise_type::return_value(JSONObject value) {
+        result = std::move(value);
         return;
     }
 
-    
-    size_t JSONObject::getNumberOfFields() const {
-        if (std::holds_alternative<std::map<JSONString, JSONObject>>(value)) {
-            auto& map = std::get<std::map<JSONString, JSONObject>>(value);
-            return map.size();
-        }
-        else {
-            throw JSONException("Removing field failed, this JSONObject is not a map");
-        }
+    inline void JSONParseTask::promise_type::unhandled_exception() {
+        error = std::current_exception();
+        return;
     }
 
-    JSONObject& JSONObject::operator[](const JSONString& key) {
-        if (std::holds_alternative<std::map<JSONString, JSONObject>>(value)) {
-            auto& map = std::get<std::map<JSONString, JSONObject>>(value);
-            return map[key];
-        }
-        else {
-            throw JSONException("Operator[] failed, this JSONObject is not a map");
+    inline JSONParseTask::JSONParseTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    inline JSONParseTask::JSONParseTask(JSONParseTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    inline JSONParseTask::~JSONParseTask() {
+        if (handle) {
+            handle.destroy();
         }
     }
 
-    const JSONObject& JSONObject::operator[](const JSONString& key) const {
-        if (std::holds_alternative<std::map<JSONString, JSONObject>>(value)) {
-            auto& map = std::get<std::map<JSONString, JSONObject>>(value);
-            return map.at(key);
-        }
-        else {
-            throw JSONException("Operator[] failed, this JSONObject is not a map");
-        }
-    }   
+    inline bool JSONParseTask::await_ready() const noexcept {
+        return handle.done();
+    }
 
-    bool operator==(const JSONObject& lhs, const JSONObject& rhs) {
-        return lhs.value == rhs.value;
-    }
-    
-    bool operator!=(const JSONObject& lhs, const JSONObject& rhs) {
-        return !(lhs == rhs);
+    inline std::coroutine_handle<> JSONParseTask::await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
     }
 
-    bool operator<(const JSONObject& lhs, const JSONObject& rhs) {
-        auto& lhsValue = lhs.value;
-        auto& rhsValue = rhs.value;
-        
-        if (std::holds_alternative<JSONString>(lhsValue) && std::holds_alternative<JSONString>(rhsValue)) {
-            return std::get<JSONString>(lhsValue) < std::get<JSONString>(rhsValue);
-        }
-        else if (std::holds_alternative<JSONNumber>(lhsValue) && std::holds_alternative<JSONNumber>(rhsValue)) {
-            return std::get<JSONNumber>(lhsValue) < std::get<JSONNumber>(rhsValue);
-        }
-        else {
-            throw JSONException("JSONObjects must hold JSONString or JSONNumber to use operator<");
+    inline JSONObject JSONParseTask::await_resume() {
+        if (handle.promise().error) {
+            std::rethrow_exception(handle.promise().error);
         }
-    }
 
-    bool operator<=(const JSONObject& lhs, const JSONObject& rhs) {
-        return (lhs < rhs) || (lhs == rhs);
+        return std::move(*handle.promise().result);
     }
 
-    bool operator>(const JSONObject& lhs, const JSONObject& rhs) {
-        auto& lhsValue = lhs.value;
-        auto& rhsValue = rhs.value;
-        
-        if (std::holds_alternative<JSONString>(lhsValue) && std::holds_alternative<JSONString>(rhsValue)) {
-            return std::get<JSONString>(lhsValue) > std::get<JSONString>(rhsValue);
-        }
-        else if (std::holds_alternative<JSONNumber>(lhsValue) && std::holds_alternative<JSONNumber>(rhsValue)) {
-            return std::get<JSONNumber>(lhsValue) > std::get<JSONNumber>(rhsValue);
-        }
-        else {
-            throw JSONException("JSONObjects must hold JSONString or JSONNumber to use operator>");
+    // JSONStreamParser
+
+    template <typename AsyncSource>
+    JSONParseTask JSONStreamParser::parse(AsyncSource& source) {
+        while (true) {
+            std::optional<std::string_view> chunk = co_await source.next();
+
+            if (!chunk) {
+                break;
+            }
+
+            feed(*chunk);
         }
-    }
 
-    bool operator>=(const JSONObject& lhs, const JSONObject& rhs) {
-        return (lhs > rhs) || (lhs == rhs);
+        co_return finish();
     }
-    
-    std::string JSONObject::toString() const {
-        if (std::holds_alternative<JSONString>(value)) {
-            return std::get<JSONString>(value).toString();
-        }
-        else if (std::holds_alternative<JSONNumber>(value)) {
-            return std::get<JSONNumber>(value).toString();
-        }
-        else if (std::holds_alternative<JSONBool>(value)) {
-            return std::get<JSONBool>(value).toString();
-        }
-        else if (std::holds_alternative<JSONNull>(value)) {
-            return std::get<JSONNull>(value).toString();
-        }
-        else if (std::holds_alternative<JSONArray>(value)) {
-            return std::get<JSONArray>(value).toString();
-        }
-        else if (std::holds_alternative<std::map<JSONString, JSONObject>>(value)) {
-            auto& map = std::get<std::map<JSONString, JSONObject>>(value);
-            
-            if (map.size() == 0) {
-                return "{}";
-            }
-            else {
-                std::string res = "{";
+#endif
+
+    template <typename F>
+    void forEachRecordInFile(const char* fileName, F&& onRecord, const size_t blockSize, const size_t blockCount) {
+        FUNCTRACE
+
+        internal::BoundedQueue__internal<JSONObject> records(256);
+        std::exception_ptr processingError;
 
-                for (auto& [key, val] : map) {
-                    res += key.toString() + ":" + val.toString() + ",";
+        std::thread processor([&]() {
+            JSONObject record;
+
+            while (records.pop(record)) {
+                try {
+                    onRecord(record);
+                }
+                catch (...) {
+                    processingError = std::current_exception();
+                    records.close();
+                    break;
                 }
+            }
+        });
 
-                res.back() = '}';
-                
-                return res;
+        JSONStreamParser parser;
+        parser.setRecordHandler([&](JSONObject record) {
+            if (!records.push(std::move(record))) {
+                throw JSONException("Record processing stopped");
             }
-        }
-        
-        // should not get here
-        throw JSONException("Error when converting JSONObject to string");
-    }
+        });
 
-    std::string JSONObject::toIndentedString(std::string& currentIndentation, const std::string& indentString) const {
-        if (std::holds_alternative<JSONString>(value)) {
-            return std::get<JSONString>(value).toString();
-        }
-        else if (std::holds_alternative<JSONNumber>(value)) {
-            return std::get<JSONNumber>(value).toString();
-        }
-        else if (std::holds_alternative<JSONBool>(value)) {
-            return std::get<JSONBool>(value).toString();
+        try {
+            JSONObject rest = internal::parsePipelined__internal(fileName, blockSize, blockCount, parser);
+
+            if (!rest.isArray()) {
+                records.push(std::move(rest));
+            }
         }
-        else if (std::holds_alternative<JSONNull>(value)) {
-            return std::get<JSONNull>(value).toString();
+        catch (...) {
+            records.close();
+            processor.join();
+
+            if (processingError) {
+                std::rethrow_exception(processingError);
+            }
+            throw;
         }
-        else if (std::holds_alternative<JSONArray>(value)) {
-            return std::get<JSONArray>(value).toIndentedString(currentIndentation, indentString);
+
+        records.close();
+        processor.join();
+
+        if (processingError) {
+            std::rethrow_exception(processingError);
         }
-        else if (std::holds_alternative<std::map<JSONString, JSONObject>>(value)) {
-            auto& map = std::get<std::map<JSONString, JSONObject>>(value);
+        return;
+    }
 
-            if (map.size() == 0) {
-                return "{}";
-            }
-            else {
-                std::string res = "{\n";
+    // JSONWriter
 
-                currentIndentation += indentString;
+    template <typename N, typename>
+    JSONWriter& JSONWriter::value(const N num) {
+        return value(JSONNumber(num));
+    }
 
-                for (auto& [key, val] : map) {
-                    res += currentIndentation + key.toString() + " : " + val.toIndentedString(currentIndentation, indentString) + ",\n";
-                }
+    // SharedDocument
+
+    template <typename F>
+    void SharedDocument::update(F&& func) {
+        FUNCTRACE
 
-                currentIndentation.erase(currentIndentation.length() - indentString.length());
+        std::shared_ptr<const JSONObject> current = std::atomic_load(&document);
+        std::shared_ptr<const JSONObject> next;
 
-                res.erase(res.length() - 2);
-                res += "\n" + currentIndentation + "}";
-                
-                return res;
-            }
+        do {
+            JSONObject copy = *current;
+            func(copy);
+            next = freeze(std::move(copy));
+        } while (!std::atomic_compare_exchange_weak(&document, &current, next));
+
+        return;
+    }
+
+    // StaticJSONView
+
+    constexpr StaticJSONView::StaticJSONView(const internal::StaticJSONNode__internal* nodes, std::string_view text, const size_t nodeIndex) 
+        : nodes(nodes), text(text), nodeIndex(nodeIndex) {}
+
+    constexpr bool StaticJSONView::isString() const {
+        return nodes[nodeIndex].type == internal::NextJsonType::JSON_STRING;
+    }
+
+    constexpr bool StaticJSONView::isNumber() const {
+        return nodes[nodeIndex].type == internal::NextJsonType::JSON_NUMBER;
+    }
+
+    constexpr bool StaticJSONView::isBool() const {
+        return nodes[nodeIndex].type == internal::NextJsonType::JSON_BOOL;
+    }
+
+    constexpr bool StaticJSONView::isNull() const {
+        return nodes[nodeIndex].type == internal::NextJsonType::JSON_NULL;
+    }
+
+    constexpr bool StaticJSONView::isArray() const {
+        return nodes[nodeIndex].type == internal::NextJsonType::JSON_ARRAY;
+    }
+
+    constexpr bool StaticJSONView::isMap() const {
+        return nodes[nodeIndex].type == internal::NextJsonType::JSON_OBJECT;
+    }
+
+    constexpr std::string_view StaticJSONView::getString() const {
+        if (!isString()) {
+            throw JSONException("This static JSON value is not a string");
         }
-        
-        // should not get here
-        throw JSONException("Error when converting JSONObject to string");
+
+        return text.substr(nodes[nodeIndex].begin, nodes[nodeIndex].end - nodes[nodeIndex].begin);
     }
 
-} // namespace simpleJSON 
+    constexpr JSONIntegral StaticJSONView::getIntegral() const {
+        if (!isNumber() || nodes[nodeIndex].isFloating) {
+            throw JSONException("This static JSON value is not an integral number");
+        }
 
-namespace internal {
-    simpleJSON::JSONObject beginParseFromStream__internal(std::istream& stream) {
-        FUNCTRACE
+        size_t pos = nodes[nodeIndex].begin;
+        bool negative = text[pos] == '-';
+        pos += negative ? 1 : 0;
 
-        simpleJSON::JSONObject result;
-        
-        char next = peekNextNonSpaceCharacter__internal(stream);
+        JSONIntegral result = 0;
 
-        internal::NextJsonType nextType = internal::detectNextType__internal(next);
+        for (; pos < nodes[nodeIndex].end; ++pos) {
+            JSONIntegral digit = text[pos] - '0';
 
-        switch (nextType) {
-            case internal::NextJsonType::JSON_STRING:
-                result = internal::parseString__internal(stream);
-                break;
-            case internal::NextJsonType::JSON_NUMBER:
-                result = internal::parseNumber__internal(stream);
-                break;
-            case internal::NextJsonType::JSON_BOOL:
-                result = internal::parseBool__internal(stream);
-                break;
-            case internal::NextJsonType::JSON_NULL:
-                result = internal::parseNull__internal(stream);
-                break;
-            case internal::NextJsonType::JSON_ARRAY:
-                result = internal::parseArray__internal(stream);
-                break;
-            case internal::NextJsonType::JSON_OBJECT:
-                result = internal::parseObject__internal(stream);
-                break;
-            case internal::NextJsonType::JSON_END_OF_STREAM:    
-                // next read will fail and function will end
-                break;
-            default: 
-                std::string errorMessage = "Error while parsing object, unexpected next character '" + std::string{next} + "'";
-                throw simpleJSON::JSONException(errorMessage.c_str());
-                break;
+            // accumulate negatively so that the minimum value can be represented
+            if (result < (std::numeric_limits<JSONIntegral>::min() + digit) / 10) {
+                throw JSONException("Static JSON integer is out of range");
+            }
+
+            result = result * 10 - digit;
         }
-   
-        next = peekNextNonSpaceCharacter__internal(stream);
 
-        if (next != std::istream::traits_type::eof()) {
-            std::string errorMessage = "Error after reading a valid json object. Expected EOF but found '" + std::string{next} + "'"; 
-            throw simpleJSON::JSONException(errorMessage.c_str());
+        if (!negative) {
+            if (result == std::numeric_limits<JSONIntegral>::min()) {
+                throw JSONException("Static JSON integer is out of range");
+            }
+            result = -result;
         }
-        
+
         return result;
     }
 
-    NextJsonType detectNextType__internal(char nextCharInStream) {
-        switch (nextCharInStream) {
-            case '"':
-                return NextJsonType::JSON_STRING;
-            case '-': [[fallthrough]];
-            case '0': [[fallthrough]];
-            case '1': [[fallthrough]];
-            case '2': [[fallthrough]];
-            case '3': [[fallthrough]];
-            case '4': [[fallthrough]];
-            case '5': [[fallthrough]];
-            case '6': [[fallthrough]];
-            case '7': [[fallthrough]];
-            case '8': [[fallthrough]];
-            case '9':
-                return NextJsonType::JSON_NUMBER;
-            case 't': [[fallthrough]];
-            case 'f':
-                return NextJsonType::JSON_BOOL;
-            case 'n':
-                return NextJsonType::JSON_NULL;
-            case '[':
-                return NextJsonType::JSON_ARRAY;
-            case '{':
-                return NextJsonType::JSON_OBJECT;
-            case std::istream::traits_type::eof():
-                return NextJsonType::JSON_END_OF_STREAM;
-            default:
-                return NextJsonType::JSON_ERROR;
+    constexpr bool StaticJSONView::getBoolean() const {
+        if (!isBool()) {
+            throw JSONException("This static JSON value is not a bool");
         }
+
+        return text[nodes[nodeIndex].begin] == 't';
     }
 
-    char peekNextNonSpaceCharacter__internal(std::istream& stream) {
-        char next = stream.peek();
-        
-        while (isspace(next)) {
-            stream.get();
-            next = stream.peek();
+    constexpr size_t StaticJSONView::size() const {
+        if (!isArray()) {
+            throw JSONException("This static JSON value is not an array, cannot call size()");
         }
 
-        return next;
+        return nodes[nodeIndex].childCount;
     }
 
-    simpleJSON::JSONFloating strToJSONFloating__internal(const std::string& str) {
-        char* afterEnd;
-        simpleJSON::JSONFloating result = std::strtold(str.c_str(), &afterEnd);
+    constexpr StaticJSONView StaticJSONView::operator[](const size_t index) const {
+        if (index >= size()) {
+            throw JSONException("StaticJSONView operator[] index out of range");
+        }
 
-        if (*afterEnd != '\0') {
-            std::string errorMessage = "Error while parsing number, invalid floating point number";
-            throw simpleJSON::JSONException(errorMessage.c_str());
+        size_t child = nodeIndex + 1;
+
+        for (size_t i = 0; i < index; ++i) {
+            child = nodes[child].subtreeEnd;
         }
 
-        return result;
+        return StaticJSONView(nodes, text, child);
     }
 
-    simpleJSON::JSONIntegral strToJSONIntegral__internal(const std::string& str) {
-        char* afterEnd;
-        simpleJSON::JSONIntegral result = std::strtoll(str.c_str(), &afterEnd, 10);
-            
-        if (*afterEnd != '\0') {
-            std::string errorMessage = "Error while parsing number, invalid signed integer";
-            throw simpleJSON::JSONException(errorMessage.c_str());
+    constexpr size_t StaticJSONView::getNumberOfFields() const {
+        if (!isMap()) {
+            throw JSONException("This static JSON value is not a map");
         }
 
-        return result;
+        return nodes[nodeIndex].childCount;
     }
 
-    simpleJSON::JSONString parseString__internal(std::istream& stream) {
-        FUNCTRACE
+    constexpr bool StaticJSONView::hasField(std::string_view key) const {
+        size_t keyNode = nodeIndex + 1;
 
-        char currentChar;
-        stream.get(currentChar);
+        for (size_t i = 0; i < getNumberOfFields(); ++i) {
+            if (StaticJSONView(nodes, text, keyNode).getString() == key) {
+                return true;
+            }
 
-        if (currentChar != '"') {
-            std::string errorMessage = "Error while parsing string, expected '\"'";
-            throw simpleJSON::JSONException(errorMessage.c_str());
+            keyNode = nodes[keyNode + 1].subtreeEnd;
         }
 
-        std::string result;
-        bool currentCharIsEscaped = false;
+        return false;
+    }
 
-        while (stream) {
-            stream.get(currentChar);
+    constexpr StaticJSONView StaticJSONView::operator[](std::string_view key) const {
+        size_t keyNode = nodeIndex + 1;
 
-            if (currentChar == '"' && !currentCharIsEscaped) {
-                return result;
-            }
-            
-            if (currentChar == '\\' && !currentCharIsEscaped) {
-                currentCharIsEscaped = true;
-            }
-            else if (currentCharIsEscaped) {
-                currentCharIsEscaped = false;
+        for (size_t i = 0; i < getNumberOfFields(); ++i) {
+            if (StaticJSONView(nodes, text, keyNode).getString() == key) {
+                return StaticJSONView(nodes, text, keyNode + 1);
             }
-            
-            result += currentChar;
+
+            keyNode = nodes[keyNode + 1].subtreeEnd;
         }
 
-        // should not get here
-        std::string errorMessage = "Error while parsing string, unexpected end of stream";
-        throw simpleJSON::JSONException(errorMessage.c_str());
+        throw JSONException("Static JSON map does not contain the requested key");
     }
 
-    simpleJSON::JSONNumber parseNumber__internal(std::istream& stream) {
-        FUNCTRACE
+    // StaticJSON
 
-        char c = stream.peek();
-        std::string numberAsString;
+    template <size_t NodeCount>
+    constexpr StaticJSON<NodeCount>::StaticJSON(std::string_view text) : text(text), nodes() {
+        internal::StaticJSONParser__internal parser{text, 0, nodes.data(), 0};
+        parser.parseDocument();
 
-        short dotCount = 0;
-        short eCount = 0;
+        if (parser.nodeCount != NodeCount) {
+            throw JSONException("StaticJSON node count does not match the document, create it with SIMPLEJSON_STATIC_JSON");
+        }
+    }
 
-        while (isdigit(c) || c == '.' || c == '-' || c == 'e' || c == 'E' || c == '+') {
-            if (c == '.') {
-                ++dotCount;
-            }
-            else if (c == 'e' || c == 'E') {
-                ++eCount;
-            }
+    template <size_t NodeCount>
+    constexpr StaticJSONView StaticJSON<NodeCount>::root() const {
+        return StaticJSONView(nodes.data(), text, 0);
+    }
 
-            stream.get(c);
-            numberAsString += c;
+    // JSONSnapshotView
 
-            c = stream.peek();
-        }
-        
-        if (dotCount != 0 || eCount != 0) {
-            return simpleJSON::JSONNumber{internal::strToJSONFloating__internal(numberAsString)};
-        }
-        else {
-            return simpleJSON::JSONNumber{internal::strToJSONIntegral__internal(numberAsString)};
+    template <typename T>
+    T JSONSnapshotView::read(const uint64_t offset) const {
+        if (offset > dataSize || dataSize - offset < sizeof(T)) {
+            throw JSONException("Snapshot read out of range");
         }
+
+        T result;
+        std::memcpy(&result, data + offset, sizeof(T));
+        return result;
     }
-    
-    simpleJSON::JSONBool parseBool__internal(std::istream& stream) {
-        FUNCTRACE
 
-        char c1, c2, c3, c4;
-        stream.get(c1);
-        stream.get(c2);
-        stream.get(c3);
-        stream.get(c4);
+    // BinaryWriter
 
-        std::string out = {c1, c2, c3, c4};
+    template <typename T>
+    void BinaryWriter::writeLittleEndian(const T val) {
+        static_assert(std::is_integral_v<T>, "BinaryWriter only writes integral values, copy floating point values into integers first");
 
-        if (out == "true") {
-            return simpleJSON::JSONBool(true);
+        auto bits = std::make_unsigned_t<T>(val);
+
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            buffer.push_back(char((bits >> (8 * i)) & 0xFF));
         }
-        else if (out[0] == 'f') {
-            char c5;
+
+        return;
+    }
+
+    template <typename T>
+    void BinaryWriter::writeBigEndian(const T val) {
+        static_assert(std::is_integral_v<T>, "BinaryWriter only writes integral values, copy floating point values into integers first");
+
+        auto bits = std::make_unsigned_t<T>(val);
+
+        for (size_t i = sizeof(T); i > 0; --i) {
+            buffer.push_back(char((bits >> (8 * (i - 1))) & 0xFF));
+        }
+
+        return;
+    }
+
+    template <typename T>
+    void BinaryWriter::patchLittleEndian(const size_t position, const T val) {
+        static_assert(std::is_integral_v<T>, "BinaryWriter only writes integral values");
+
+        if (position + sizeof(T) > buffer.size()) {
+            throw JSONException("BinaryWriter patch position out of range");
+        }
+
+        auto bits = std::make_unsigned_t<T>(val);
+
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            buffer[position + i] = char((bits >> (8 * i)) & 0xFF);
+        }
+
+        return;
+    }
+
+    // BinaryReader
+
+    template <typename T>
+    T BinaryReader::readLittleEndian() {
+        static_assert(std::is_integral_v<T>, "BinaryReader only reads integral values");
+
+        require(sizeof(T));
+        std::make_unsigned_t<T> bits = 0;
+
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bits |= std::make_unsigned_t<T>(uint8_t(bytes[pos + i])) << (8 * i);
+        }
+
+        pos += sizeof(T);
+        return T(bits);
+    }
+
+    template <typename T>
+    T BinaryReader::readBigEndian() {
+        static_assert(std::is_integral_v<T>, "BinaryReader only reads integral values");
+
+        require(sizeof(T));
+        std::make_unsigned_t<T> bits = 0;
+
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bits = std::make_unsigned_t<T>(bits << 8) | uint8_t(bytes[pos + i]);
+        }
+
+        pos += sizeof(T);
+        return T(bits);
+    }
+
+} // namespace simpleJSON 
+
+namespace internal {
+    template <typename T>
+    void appendSnapshotValue__internal(std::string& out, const T& val) {
+        out.append(reinterpret_cast<const char*>(&val), sizeof(T));
+        return;
+    }
+
+    template <typename T>
+    T minOf__internal(const T* data, const size_t count) {
+        T result = data[0];
+        size_t i = 1;
+
+#ifdef __AVX2__
+        if constexpr (std::is_integral_v<T> && sizeof(T) == sizeof(int64_t)) {
+            if (count >= 4) {
+                __m256i best = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+
+                for (i = 4; i + 4 <= count; i += 4) {
+                    __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    best = _mm256_blendv_epi8(best, next, _mm256_cmpgt_epi64(best, next));
+                }
+
+                alignas(32) int64_t lanes[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), best);
+                result = T(std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3])));
+            }
+        }
+#endif
+
+        for (; i < count; ++i) {
+            result = data[i] < result ? data[i] : result;
+        }
+
+        return result;
+    }
+
+    template <typename T>
+    T maxOf__internal(const T* data, const size_t count) {
+        T result = data[0];
+        size_t i = 1;
+
+#ifdef __AVX2__
+        if constexpr (std::is_integral_v<T> && sizeof(T) == sizeof(int64_t)) {
+            if (count >= 4) {
+                __m256i best = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+
+                for (i = 4; i + 4 <= count; i += 4) {
+                    __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    best = _mm256_blendv_epi8(best, next, _mm256_cmpgt_epi64(next, best));
+                }
+
+                alignas(32) int64_t lanes[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), best);
+                result = T(std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3])));
+            }
+        }
+#endif
+
+        for (; i < count; ++i) {
+            result = data[i] > result ? data[i] : result;
+        }
+
+        return result;
+    }
+
+    constexpr void StaticJSONParser__internal::skipWhitespace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+            ++pos;
+        }
+    }
+
+    constexpr void StaticJSONParser__internal::parseDocument() {
+        parseValue();
+        skipWhitespace();
+
+        if (pos != text.size()) {
+            throw syntaxError(simpleJSON::JSONSyntaxErrorKind::EXPECTED_END_OF_INPUT);
+        }
+    }
+
+    constexpr size_t StaticJSONParser__internal::parseValue() {
+        skipWhitespace();
+
+        if (pos >= text.size()) {
+            throw syntaxError(simpleJSON::JSONSyntaxErrorKind::UNEXPECTED_END_OF_INPUT);
+        }
+
+        size_t index = nodeCount++;
+        StaticJSONNode__internal node;
+        node.begin = pos;
+
+        char c = text[pos];
+
+        if (c == '"') {
+            node.type = NextJsonType::JSON_STRING;
+            parseString();
+            // string nodes span the contents between the quotes
+            node.begin += 1;
+            node.end = pos - 1;
+        }
+        else if (c == '-' || (c >= '0' && c <= '9')) {
+            node.type = NextJsonType::JSON_NUMBER;
+            node.isFloating = parseNumber();
+            node.end = pos;
+        }
+        else if (c == 't' || c == 'f') {
+            node.type = NextJsonType::JSON_BOOL;
+            parseLiteral(c == 't' ? "true" : "false");
+            node.end = pos;
+        }
+        else if (c == 'n') {
+            node.type = NextJsonType::JSON_NULL;
+            parseLiteral("null");
+            node.end = pos;
+        }
+        else if (c == '[' || c == '{') {
+            bool isMap = c == '{';
+            char close = isMap ? '}' : ']';
+
+            node.type = isMap ? NextJsonType::JSON_OBJECT : NextJsonType::JSON_ARRAY;
+            ++pos;
+            skipWhitespace();
+
+            if (pos < text.size() && text[pos] == close) {
+                ++pos;
+            }
+            else {
+                while (true) {
+                    if (isMap) {
+                        skipWhitespace();
+
+                        if (pos >= text.size() || text[pos] != '"') {
+                            throw syntaxError(simpleJSON::JSONSyntaxErrorKind::EXPECTED_KEY);
+                        }
+
+                        parseValue();
+                        skipWhitespace();
+
+                        if (pos >= text.size() || text[pos] != ':') {
+                            throw syntaxError(simpleJSON::JSONSyntaxErrorKind::EXPECTED_COLON);
+                        }
+
+                        ++pos;
+                    }
+
+                    parseValue();
+                    ++node.childCount;
+                    skipWhitespace();
+
+                    if (pos < text.size() && text[pos] == ',') {
+                        ++pos;
+                    }
+                    else if (pos < text.size() && text[pos] == close) {
+                        ++pos;
+                        break;
+                    }
+                    else {
+                        throw syntaxError(simpleJSON::JSONSyntaxErrorKind::EXPECTED_COMMA_OR_END);
+                    }
+                }
+            }
+
+            node.end = pos;
+        }
+        else {
+            throw syntaxError(simpleJSON::JSONSyntaxErrorKind::UNEXPECTED_CHARACTER);
+        }
+
+        node.subtreeEnd = nodeCount;
+
+        if (nodes) {
+            nodes[index] = node;
+        }
+
+        return index;
+    }
+
+    constexpr void StaticJSONParser__internal::parseString() {
+        ++pos;
+
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos];
+
+            if (static_cast<unsigned char>(c) < 0x20) {
+                throw syntaxError(simpleJSON::JSONSyntaxErrorKind::CONTROL_CHARACTER_IN_STRING);
+            }
+
+            if (c == '\\') {
+                ++pos;
+
+                if (pos >= text.size()) {
+                    break;
+                }
+
+                char escaped = text[pos];
+
+                if (escaped == 'u') {
+                    for (size_t i = 1; i <= 4; ++i) {
+                        char hex = pos + i < text.size() ? text[pos + i] : '\0';
+
+                        if (!((hex >= '0' && hex <= '9') || (hex >= 'a' && hex <= 'f') || (hex >= 'A' && hex <= 'F'))) {
+                            throw syntaxError(simpleJSON::JSONSyntaxErrorKind::INVALID_UNICODE_ESCAPE);
+                        }
+                    }
+
+                    pos += 4;
+                }
+                else if (escaped != '"' && escaped != '\\' && escaped != '/' && escaped != 'b' && escaped != 'f' && escaped != 'n' && escaped != 'r' && escaped != 't') {
+                    throw syntaxError(simpleJSON::JSONSyntaxErrorKind::INVALID_ESCAPE);
+                }
+            }
+
+            ++pos;
+        }
+
+        if (pos >= text.size()) {
+            throw syntaxError(simpleJSON::JSONSyntaxErrorKind::UNTERMINATED_STRING);
+        }
+
+        ++pos;
+    }
+
+    constexpr bool StaticJSONParser__internal::parseNumber() {
+        auto isDigit = [&](size_t at) { return at < text.size() && text[at] >= '0' && text[at] <= '9'; };
+        bool isFloating = false;
+
+        if (text[pos] == '-') {
+            ++pos;
+        }
+
+        if (pos < text.size() && text[pos] == '0') {
+            ++pos;
+        }
+        else if (isDigit(pos)) {
+            while (isDigit(pos)) {
+                ++pos;
+            }
+        }
+        else {
+            throw syntaxError(simpleJSON::JSONSyntaxErrorKind::INVALID_NUMBER);
+        }
+
+        if (pos < text.size() && text[pos] == '.') {
+            isFloating = true;
+            ++pos;
+
+            if (!isDigit(pos)) {
+                throw syntaxError(simpleJSON::JSONSyntaxErrorKind::EXPECTED_FRACTION_DIGITS);
+            }
+
+            while (isDigit(pos)) {
+                ++pos;
+            }
+        }
+
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+            isFloating = true;
+            ++pos;
+
+            if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+                ++pos;
+            }
+
+            if (!isDigit(pos)) {
+                throw syntaxError(simpleJSON::JSONSyntaxErrorKind::EXPECTED_EXPONENT_DIGITS);
+            }
+
+            while (isDigit(pos)) {
+                ++pos;
+            }
+        }
+
+        return isFloating;
+    }
+
+    constexpr void StaticJSONParser__internal::parseLiteral(std::string_view literal) {
+        if (text.substr(pos, literal.size()) != literal) {
+            throw syntaxError(simpleJSON::JSONSyntaxErrorKind::INVALID_LITERAL);
+        }
+
+        pos += literal.size();
+    }
+
+    constexpr size_t countStaticJSONNodes__internal(std::string_view text) {
+        StaticJSONParser__internal parser{text, 0, nullptr, 0};
+        parser.parseDocument();
+        return parser.nodeCount;
+    }
+
+    constexpr uint64_t hashKey__internal(std::string_view key) {
+        uint64_t hash = 14695981039346656037ull;
+
+        for (char c : key) {
+            hash ^= uint64_t(static_cast<unsigned char>(c));
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    template <typename T>
+    void readStructValue__internal(StructReader__internal& reader, T& out) {
+        if constexpr (std::is_same_v<T, bool>) {
+            out = reader.readBool();
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            std::string_view token = reader.readNumberToken();
+            auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), out);
+
+            if (error != std::errc() || end != token.data() + token.size()) {
+                reader.fail("invalid integer \"" + std::string(token) + "\" for the bound member type");
+            }
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            std::string_view token = reader.readNumberToken();
+            out = T(strToJSONFloating__internal(std::string(token)));
+        }
+        else if constexpr (std::is_same_v<T, std::string>) {
+            std::string_view raw = reader.readRawString();
+            out = raw.find('\\') == std::string_view::npos ? std::string(raw) : unescapeString__internal(std::string(raw));
+        }
+        else if constexpr (IsOptional__internal<T>::value) {
+            if (reader.readNullIfPresent()) {
+                out.reset();
+            }
+            else {
+                typename T::value_type val{};
+                readStructValue__internal(reader, val);
+                out = std::move(val);
+            }
+        }
+        else if constexpr (IsVector__internal<T>::value) {
+            out.clear();
+            reader.expect('[');
+
+            if (reader.consumeIf(']')) {
+                return;
+            }
+
+            do {
+                typename T::value_type elem{};
+                readStructValue__internal(reader, elem);
+                out.push_back(std::move(elem));
+            } while (reader.consumeIf(','));
+
+            reader.expect(']');
+        }
+        else if constexpr (IsBoundStruct__internal<T>::value) {
+            reader.expect('{');
+
+            if (reader.consumeIf('}')) {
+                return;
+            }
+
+            do {
+                std::string_view key = reader.readRawString();
+                reader.expect(':');
+
+                // a key is hashed once and compared against the precomputed hashes of the bound fields
+                uint64_t hash = hashKey__internal(key);
+
+                bool matched = std::apply([&](const auto&... field) {
+                    return (... || (field.hash == hash && field.name == key && (readStructValue__internal(reader, out.*(field.member)), true)));
+                }, simpleJSON::JSONBinding<T>::fields);
+
+                if (!matched) {
+                    reader.skipValue();
+                }
+            } while (reader.consumeIf(','));
+
+            reader.expect('}');
+        }
+        else {
+            static_assert(IsBoundStruct__internal<T>::value, "Type is not supported by struct binding, specialize simpleJSON::JSONBinding for it");
+        }
+        return;
+    }
+
+    template <typename T>
+    void writeStructValue__internal(std::string& out, const T& val) {
+        if constexpr (std::is_same_v<T, bool>) {
+            out += val ? "true" : "false";
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            // formats every integral type directly, unsigned 64 bit values do not fit JSONIntegral
+            char buffer[24];
+            out.append(buffer, size_t(std::to_chars(buffer, buffer + sizeof(buffer), val).ptr - buffer));
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            if (!std::isfinite(val)) {
+                throw simpleJSON::JSONException("Struct binding can only write finite numbers");
+            }
+
+            if constexpr (sizeof(T) <= sizeof(double)) {
+                // shortest digits that read back as the same value
+                char buffer[32];
+                out.append(buffer, formatCanonicalNumber__internal(double(val), buffer));
+            }
+            else {
+                // narrowing to double for the canonical writer would drop digits
+                char buffer[64];
+                out.append(buffer, size_t(std::to_chars(buffer, buffer + sizeof(buffer), val).ptr - buffer));
+            }
+        }
+        else if constexpr (std::is_same_v<T, std::string>) {
+            out += '"';
+            out += escapeString__internal(val);
+            out += '"';
+        }
+        else if constexpr (IsOptional__internal<T>::value) {
+            if (val) {
+                writeStructValue__internal(out, *val);
+            }
+            else {
+                out += "null";
+            }
+        }
+        else if constexpr (IsVector__internal<T>::value) {
+            out += '[';
+
+            bool first = true;
+
+            for (const auto& elem : val) {
+                if (!first) {
+                    out += ',';
+                }
+                first = false;
+                writeStructValue__internal(out, elem);
+            }
+
+            out += ']';
+        }
+        else if constexpr (IsBoundStruct__internal<T>::value) {
+            out += '{';
+
+            bool first = true;
+
+            std::apply([&](const auto&... field) {
+                ((out += first ? "\"" : ",\"", first = false, out += field.name, out += "\":", writeStructValue__internal(out, val.*(field.member))), ...);
+            }, simpleJSON::JSONBinding<T>::fields);
+
+            out += '}';
+        }
+        else {
+            static_assert(IsBoundStruct__internal<T>::value, "Type is not supported by struct binding, specialize simpleJSON::JSONBinding for it");
+        }
+        return;
+    }
+
+    template <typename T>
+    BoundedQueue__internal<T>::BoundedQueue__internal(const size_t capacity) : capacity(std::max(size_t(1), capacity)), closed(false) {}
+
+    template <typename T>
+    bool BoundedQueue__internal<T>::push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&]() { return closed || items.size() < capacity; });
+
+        if (closed) {
+            return false;
+        }
+
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    template <typename T>
+    bool BoundedQueue__internal<T>::pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [&]() { return closed || !items.empty(); });
+
+        if (items.empty()) {
+            return false;
+        }
+
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    template <typename T>
+    void BoundedQueue__internal<T>::close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+        return;
+    }
+
+    // DocumentPrinter__internal
+
+    template <typename Output>
+    DocumentPrinter__internal<Output>::DocumentPrinter__internal(Output& out, const simpleJSON::PrettyPrintOptions* options, std::string_view baseIndentation)
+        : out(out), options(options), indentTable(baseIndentation), baseIndentationLength(baseIndentation.size()) {}
+
+    template <typename Output>
+    void DocumentPrinter__internal<Output>::print(const simpleJSON::JSONObject& obj) {
+        FUNCTRACE
+
+        beginValue(obj);
+        run();
+        return;
+    }
+
+    template <typename Output>
+    void DocumentPrinter__internal<Output>::print(const simpleJSON::JSONArray& arr) {
+        FUNCTRACE
+
+        beginArray(arr);
+        run();
+        return;
+    }
+
+    template <typename Output>
+    void DocumentPrinter__internal<Output>::beginValue(const simpleJSON::JSONObject& obj) {
+        if (obj.isArray()) {
+            beginArray(obj.asArray());
+        }
+        else if (obj.isMap()) {
+            const simpleJSON::JSONMap& map = obj.asMap();
+
+            if (map.empty()) {
+                out += "{}";
+            }
+            else {
+                out += '{';
+                stack.push_back(Frame{nullptr, 0, map.begin(), map.end()});
+            }
+        }
+        else {
+            writeScalar(obj);
+        }
+
+        return;
+    }
+
+    template <typename Output>
+    void DocumentPrinter__internal<Output>::beginArray(const simpleJSON::JSONArray& arr) {
+        size_t size = arr.size();
+
+        if (size == 0) {
+            out += "[]";
+            return;
+        }
+
+        bool compact = options && size <= options->compactArrayLimit;
+
+        for (size_t i = 0; compact && !arr.isPacked() && i < size; ++i) {
+            compact = !arr[i].isArray() && !arr[i].isMap();
+        }
+
+        if (compact) {
+            bool first = true;
+            out += '[';
+
+            arr.forEach([&](const simpleJSON::JSONObject& elem) {
+                if (!first) {
+                    out += ", ";
+                }
+                first = false;
+                writeScalar(elem);
+            });
+
+            out += ']';
+        }
+        else if (arr.isPacked()) {
+            // packed arrays only hold numbers, so they are written without a stack frame
+            size_t depth = stack.size() + 1;
+            bool first = true;
+            out += '[';
+
+            arr.forEach([&](const simpleJSON::JSONObject& elem) {
+                writeSeparator(first, depth);
+                first = false;
+                writeScalar(elem);
+            });
+
+            writeClosing(']', depth - 1);
+        }
+        else {
+            out += '[';
+            stack.push_back(Frame{&arr, 0, {}, {}});
+        }
+
+        return;
+    }
+
+    template <typename Output>
+    void DocumentPrinter__internal<Output>::writeScalar(const simpleJSON::JSONObject& obj) {
+        if (obj.isString()) {
+            out += '"';
+            out += obj.asString().getStringView();
+            out += '"';
+        }
+        else if (obj.isNumber()) {
+            appendNumber__internal(out, obj.asNumber());
+        }
+        else if (obj.isBool()) {
+            out += obj.asBool().getBoolean() ? "true" : "false";
+        }
+        else {
+            out += "null";
+        }
+
+        return;
+    }
+
+    template <typename Output>
+    void DocumentPrinter__internal<Output>::writeSeparator(const bool first, const size_t depth) {
+        if (!first) {
+            out += ',';
+        }
+
+        if (options) {
+            out += '\n';
+            writeIndentation(depth);
+        }
+
+        return;
+    }
+
+    template <typename Output>
+    void DocumentPrinter__internal<Output>::writeClosing(const char bracket, const size_t depth) {
+        if (options) {
+            out += '\n';
+            writeIndentation(depth);
+        }
+
+        out += bracket;
+        return;
+    }
+
+    template <typename Output>
+    void DocumentPrinter__internal<Output>::writeIndentation(const size_t depth) {
+        size_t length = baseIndentationLength + depth * options->indentString.size();
+
+        while (indentTable.size() < length) {
+            indentTable += options->indentString;
+        }
+
+        out.append(indentTable.data(), length);
+        return;
+    }
+
+    template <typename Output>
+    void DocumentPrinter__internal<Output>::run() {
+        while (!stack.empty()) {
+            // beginValue may push a new frame, so frame must not be used after calling it
+            Frame& frame = stack.back();
+            size_t depth = stack.size();
+
+            if (frame.array && frame.index < frame.array->size()) {
+                writeSeparator(frame.index == 0, depth);
+
+                const simpleJSON::JSONObject& elem = (*frame.array)[frame.index++];
+                beginValue(elem);
+            }
+            else if (!frame.array && frame.field != frame.fieldsEnd) {
+                writeSeparator(frame.index++ == 0, depth);
+
+                const auto& [key, val] = *frame.field++;
+                out += '"';
+                out += key.getStringView();
+                out += '"';
+                out += options ? std::string_view(options->keySeparator) : std::string_view(":");
+                beginValue(val);
+            }
+            else {
+                char bracket = frame.array ? ']' : '}';
+                stack.pop_back();
+                writeClosing(bracket, depth - 1);
+            }
+        }
+
+        return;
+    }
+
+    template <typename Output>
+    void writeCanonical__internal(Output& out, const simpleJSON::JSONObject& obj) {
+        if (obj.isString()) {
+            out += '"';
+            out += canonicalString__internal(obj.asString().getString());
+            out += '"';
+        }
+        else if (obj.isNumber()) {
+            double value = canonicalDouble__internal(obj.asNumber());
+
+            if (!std::isfinite(value)) {
+                throw simpleJSON::JSONException("Canonical JSON can only hold numbers that are finite doubles");
+            }
+
+            char buffer[32];
+            out += std::string_view(buffer, formatCanonicalNumber__internal(value, buffer));
+        }
+        else if (obj.isBool()) {
+            out += obj.asBool().getBoolean() ? "true" : "false";
+        }
+        else if (obj.isNull()) {
+            out += "null";
+        }
+        else if (obj.isArray()) {
+            bool first = true;
+            out += '[';
+
+            obj.asArray().forEach([&](const simpleJSON::JSONObject& elem) {
+                if (!first) {
+                    out += ',';
+                }
+                first = false;
+                writeCanonical__internal(out, elem);
+            });
+
+            out += ']';
+        }
+        else {
+            const simpleJSON::JSONMap& map = obj.asMap();
+
+            // keys are compared unescaped, a deque keeps the unescaped copies in place while the fields are sorted
+            std::deque<std::string> unescapedKeys;
+            std::vector<std::pair<std::string_view, const simpleJSON::JSONObject*>> fields;
+            fields.reserve(map.size());
+
+            for (auto& [key, val] : map) {
+                std::string_view name = key.getStringView();
+
+                if (name.find('\\') != std::string_view::npos) {
+                    unescapedKeys.push_back(unescapeString__internal(std::string(name)));
+                    name = unescapedKeys.back();
+                }
+
+                fields.emplace_back(name, &val);
+            }
+
+            std::sort(fields.begin(), fields.end(), [](const auto& lhs, const auto& rhs) {
+                return utf16Less__internal(lhs.first, rhs.first);
+            });
+
+            // keys spelled differently in the map, like "a" and "\u0061", can name the same member
+            for (size_t i = 1; i < fields.size(); ++i) {
+                if (fields[i - 1].first == fields[i].first) {
+                    std::string errorMessage = "Canonical JSON cannot hold duplicate member name \"" + escapeString__internal(fields[i].first) + "\"";
+                    throw simpleJSON::JSONException(errorMessage.c_str());
+                }
+            }
+
+            bool first = true;
+            out += '{';
+
+            for (auto& [name, val] : fields) {
+                if (!first) {
+                    out += ',';
+                }
+                first = false;
+
+                out += '"';
+                out += escapeString__internal(name);
+                out += "\":";
+                writeCanonical__internal(out, *val);
+            }
+
+            out += '}';
+        }
+
+        return;
+    }
+
+    template <typename F>
+    void parallelFor__internal(const size_t taskCount, size_t threadCount, F&& task) {
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        threadCount = std::min(threadCount, taskCount);
+
+        if (threadCount <= 1) {
+            for (size_t i = 0; i < taskCount; ++i) {
+                task(i);
+            }
+            return;
+        }
+
+        std::atomic<size_t> nextTask{0};
+        std::exception_ptr firstError;
+        std::mutex errorMutex;
+
+        auto worker = [&]() {
+            for (size_t i = nextTask++; i < taskCount; i = nextTask++) {
+                try {
+                    task(i);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!firstError) {
+                        firstError = std::current_exception();
+                    }
+                    nextTask = taskCount;
+                }
+            }
+        };
+
+        WorkerPool__internal::shared().run(worker, threadCount - 1);
+
+        if (firstError) {
+            std::rethrow_exception(firstError);
+        }
+        return;
+    }
+
+    template <typename T, typename Compare>
+    void parallelStableSort__internal(std::vector<T>& items, Compare comp, const size_t threadCount) {
+        constexpr size_t minItemsPerThread = 1 << 14;
+
+        size_t threads = threadCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threadCount;
+        size_t runCount = std::min(threads, items.size() / minItemsPerThread);
+
+        if (runCount <= 1) {
+            std::stable_sort(items.begin(), items.end(), comp);
+            return;
+        }
+
+        // sort equally sized runs in parallel, then merge neighbouring runs pairwise until one run is left
+        std::vector<size_t> bounds(runCount + 1);
+        for (size_t i = 0; i <= runCount; ++i) {
+            bounds[i] = items.size() * i / runCount;
+        }
+
+        parallelFor__internal(runCount, threads, [&](size_t run) {
+            std::stable_sort(items.begin() + bounds[run], items.begin() + bounds[run + 1], comp);
+        });
+
+        for (size_t width = 1; width < runCount; width *= 2) {
+            size_t mergeCount = (runCount + 2 * width - 1) / (2 * width);
+
+            parallelFor__internal(mergeCount, threads, [&](size_t merge) {
+                size_t first = merge * 2 * width;
+                size_t middle = std::min(first + width, runCount);
+                size_t last = std::min(first + 2 * width, runCount);
+
+                if (middle < last) {
+                    std::inplace_merge(items.begin() + bounds[first], items.begin() + bounds[middle], items.begin() + bounds[last], comp);
+                }
+            });
+        }
+        return;
+    }
+} // namespace internal
+
+#if SIMPLEJSON_DEFINE_NON_TEMPLATES
+
+namespace simpleJSON {
+    SIMPLEJSON_INLINE JSONObject parseFromFile(const char* fileName) {
+        FUNCTRACE
+
+        std::ifstream stream(fileName);
+        return internal::beginParseFromStream__internal(stream);
+    }
+
+    SIMPLEJSON_INLINE JSONObject parseFromString(const std::string& jsonString) {
+        FUNCTRACE
+
+        internal::MemoryStreamBuffer__internal buffer(jsonString);
+        std::istream stream(&buffer);
+        return internal::beginParseFromStream__internal(stream);
+    }
+
+    SIMPLEJSON_INLINE JSONObject parseFromFilePipelined(const char* fileName, const size_t blockSize, const size_t blockCount) {
+        FUNCTRACE
+
+        JSONStreamParser parser;
+        return internal::parsePipelined__internal(fileName, blockSize, blockCount, parser);
+    }
+
+    // void dumpToFile(const char* fileName);
+
+    SIMPLEJSON_INLINE std::string dumpToString(const JSONObject& obj) {
+        std::string res;
+        res.reserve(measure(obj));
+        internal::DocumentPrinter__internal<std::string>(res, nullptr, "").print(obj);
+        return res;
+    }
+
+    SIMPLEJSON_INLINE std::string dumpToCanonicalString(const JSONObject& obj) {
+        std::string res;
+        internal::writeCanonical__internal(res, obj);
+        return res;
+    }
+
+    SIMPLEJSON_INLINE void hashCanonical(const JSONObject& obj, SHA256& hash) {
+        internal::SHA256Sink__internal sink{hash};
+        internal::writeCanonical__internal(sink, obj);
+        return;
+    }
+
+    SIMPLEJSON_INLINE std::array<uint8_t, 32> canonicalSHA256(const JSONObject& obj) {
+        SHA256 hash;
+        hashCanonical(obj, hash);
+        return hash.finish();
+    }
+
+    SIMPLEJSON_INLINE void minify(std::istream& in, std::ostream& out) {
+        JSONWriter writer(out);
+        internal::reformat__internal(in, writer);
+        return;
+    }
+
+    SIMPLEJSON_INLINE void prettify(std::istream& in, std::ostream& out, const std::string& indentString) {
+        JSONWriter writer(out, indentString);
+        internal::reformat__internal(in, writer);
+        return;
+    }
+
+    SIMPLEJSON_INLINE std::string minify(std::string_view json) {
+        std::string res;
+        res.reserve(json.size());
+
+        internal::minifyDocument__internal(json, res);
+        return res;
+    }
+
+    SIMPLEJSON_INLINE std::string prettify(std::string_view json, const std::string& indentString) {
+        std::string res;
+        res.reserve(json.size() + json.size() / 2);
+
+        JSONWriter writer(res, indentString);
+        internal::reformat__internal(json, writer);
+        return res;
+    }
+
+    SIMPLEJSON_INLINE size_t measure(const JSONObject& obj) {
+        internal::LengthCounter__internal counter;
+        internal::DocumentPrinter__internal<internal::LengthCounter__internal>(counter, nullptr, "").print(obj);
+        return counter.length;
+    }
+
+    SIMPLEJSON_INLINE size_t measure(const JSONObject& obj, const PrettyPrintOptions& options) {
+        internal::LengthCounter__internal counter;
+        internal::DocumentPrinter__internal<internal::LengthCounter__internal>(counter, &options, "").print(obj);
+        return counter.length;
+    }
+
+    SIMPLEJSON_INLINE std::string dumpToPrettyString(const JSONObject& obj, const std::string& indentString) {
+        PrettyPrintOptions options;
+        options.indentString = indentString;
+        return dumpToPrettyString(obj, options);
+    }
+
+    SIMPLEJSON_INLINE std::string dumpToPrettyString(const JSONObject& obj, const PrettyPrintOptions& options) {
+        std::string res;
+        res.reserve(measure(obj, options));
+        internal::DocumentPrinter__internal<std::string>(res, &options, "").print(obj);
+        return res;
+    }
+
+    SIMPLEJSON_INLINE std::string dumpToStringParallel(const JSONObject& obj, const size_t threadCount) {
+        FUNCTRACE
+
+        std::string res;
+        std::string currentIndentation = "";
+        internal::dumpParallel__internal(obj, res, currentIndentation, nullptr, threadCount);
+        return res;
+    }
+
+    SIMPLEJSON_INLINE std::string dumpToPrettyStringParallel(const JSONObject& obj, const std::string& indentString, const size_t threadCount) {
+        FUNCTRACE
+
+        std::string res;
+        std::string currentIndentation = "";
+        internal::dumpParallel__internal(obj, res, currentIndentation, &indentString, threadCount);
+        return res;
+    }
+
+    SIMPLEJSON_INLINE bool equalsParallel(const JSONObject& lhs, const JSONObject& rhs, const size_t threadCount) {
+        FUNCTRACE
+
+        std::atomic<bool> mismatch = false;
+        return internal::equalsParallel__internal(lhs, rhs, threadCount, mismatch) && !mismatch;
+    }
+
+    SIMPLEJSON_INLINE uint64_t structuralHash(const JSONObject& obj, const size_t threadCount) {
+        FUNCTRACE
+
+        return internal::hashParallel__internal(obj, threadCount);
+    }
+
+    SIMPLEJSON_INLINE std::vector<JSONDifference> diff(const JSONObject& lhs, const JSONObject& rhs, const size_t threadCount) {
+        FUNCTRACE
+
+        std::vector<JSONDifference> differences;
+        internal::diffParallel__internal(lhs, rhs, JSONPointer(), differences, threadCount);
+        return differences;
+    }
+
+    SIMPLEJSON_INLINE void saveSnapshot(const JSONObject& obj, const char* fileName) {
+        FUNCTRACE
+
+        std::string snapshot = dumpToSnapshotString(obj);
+
+        std::ofstream stream(fileName, std::ios::binary | std::ios::trunc);
+        stream.write(snapshot.data(), snapshot.size());
+
+        if (!stream) {
+            throw JSONException("Error while writing snapshot file");
+        }
+    }
+
+    SIMPLEJSON_INLINE std::string dumpToSnapshotString(const JSONObject& obj) {
+        FUNCTRACE
+
+        std::string out(internal::snapshotMagic, sizeof(internal::snapshotMagic));
+        internal::appendSnapshotValue__internal(out, uint64_t(0));
+
+        uint64_t rootOffset = internal::writeSnapshotNode__internal(out, obj);
+        std::memcpy(&out[sizeof(internal::snapshotMagic)], &rootOffset, sizeof(rootOffset));
+
+        return out;
+    }
+
+    SIMPLEJSON_INLINE std::vector<BatchParseResult> parseBatch(const std::string_view* documents, const size_t documentCount, const size_t threadCount) {
+        FUNCTRACE
+
+        // documents are handed out in chunks so that workers reuse their stream and touch the shared counter rarely
+        constexpr size_t documentsPerChunk = 32;
+
+        std::vector<BatchParseResult> results(documentCount);
+        size_t chunkCount = (documentCount + documentsPerChunk - 1) / documentsPerChunk;
+
+        internal::parallelFor__internal(chunkCount, threadCount, [&](const size_t chunk) {
+            internal::MemoryStreamBuffer__internal buffer{std::string_view{}};
+            std::istream stream(&buffer);
+
+            size_t end = std::min(documentCount, (chunk + 1) * documentsPerChunk);
+
+            for (size_t i = chunk * documentsPerChunk; i < end; ++i) {
+                internal::parseBatchDocument__internal(buffer, stream, documents[i], results[i]);
+            }
+        });
+
+        return results;
+    }
+
+    SIMPLEJSON_INLINE std::vector<BatchParseResult> parseBatch(const std::vector<std::string_view>& documents, const size_t threadCount) {
+        return parseBatch(documents.data(), documents.size(), threadCount);
+    }
+
+    SIMPLEJSON_INLINE std::vector<BatchParseResult> parseFiles(const std::vector<std::string>& fileNames, const size_t threadCount, 
+                                                               const size_t queueDepth, const FileReadBackend backend) {
+        FUNCTRACE
+
+        std::vector<BatchParseResult> results(fileNames.size());
+
+#ifdef SIMPLEJSON_HAS_IO_URING
+        if (backend == FileReadBackend::AUTO && internal::parseFilesWithIoUring__internal(fileNames, threadCount, queueDepth, results)) {
+            return results;
+        }
+#else
+        (void)queueDepth;
+        (void)backend;
+#endif
+
+        internal::parseFilesWithThreadPool__internal(fileNames, threadCount, results);
+        return results;
+    }
+
+    SIMPLEJSON_INLINE std::shared_ptr<const JSONObject> freeze(JSONObject obj) {
+        FUNCTRACE
+
+        internal::unpackArrays__internal(obj);
+        return std::make_shared<const JSONObject>(std::move(obj));
+    }
+
+    SIMPLEJSON_INLINE std::string dumpToBSON(const JSONObject& obj) {
+        return dumpToBinary<BSONCodec>(obj);
+    }
+
+    SIMPLEJSON_INLINE JSONObject parseFromBSON(std::string_view bytes) {
+        return parseFromBinary<BSONCodec>(bytes);
+    }
+
+    SIMPLEJSON_INLINE std::string dumpToUBJSON(const JSONObject& obj) {
+        return dumpToBinary<UBJSONCodec>(obj);
+    }
+
+    SIMPLEJSON_INLINE JSONObject parseFromUBJSON(std::string_view bytes) {
+        return parseFromBinary<UBJSONCodec>(bytes);
+    }
+
+    // JSONexception
+
+    SIMPLEJSON_INLINE JSONException::JSONException(const char* msg) : message(msg) {}
+
+    SIMPLEJSON_INLINE JSONException::JSONException(const std::string& msg) : message(msg) {}
+
+    SIMPLEJSON_INLINE const char* JSONException::what () const throw () {
+        return message.c_str();
+    }
+
+    // JSONSyntaxError
+
+    SIMPLEJSON_INLINE JSONSyntaxError::JSONSyntaxError(const JSONSyntaxErrorKind kind, const size_t offset, const char* source) 
+        : JSONException(internal::syntaxErrorMessage__internal(kind, offset, source)), kind(kind), offset(offset) {}
+
+    SIMPLEJSON_INLINE JSONSyntaxErrorKind JSONSyntaxError::getKind() const {
+        return kind;
+    }
+
+    SIMPLEJSON_INLINE size_t JSONSyntaxError::getOffset() const {
+        return offset;
+    }
+
+    // JSONString
+
+    SIMPLEJSON_INLINE bool operator==(const JSONString& lhs, const JSONString& rhs) { 
+        return lhs.value == rhs.value;
+    }
+
+    SIMPLEJSON_INLINE bool operator!=(const JSONString& lhs, const JSONString& rhs) { 
+        return !(lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE bool operator<(const JSONString& lhs, const JSONString& rhs) { 
+        return lhs.value < rhs.value;
+    }
+
+    SIMPLEJSON_INLINE bool operator<=(const JSONString& lhs, const JSONString& rhs) { 
+        return (lhs < rhs) || (lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE bool operator>(const JSONString& lhs, const JSONString& rhs) { 
+        return lhs.value > rhs.value;
+    }
+
+    SIMPLEJSON_INLINE bool operator>=(const JSONString& lhs, const JSONString& rhs) { 
+        return (lhs > rhs) || (lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE JSONString::JSONString() : value(std::string{}) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONString::JSONString(const char* str) : value(std::string(str)) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONString::JSONString(const std::string& str) : value(str) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE std::string JSONString::getString() const {
+        return value;
+    }
+
+    SIMPLEJSON_INLINE std::string_view JSONString::getStringView() const {
+        return value;
+    }
+
+    SIMPLEJSON_INLINE std::string JSONString::toString() const {
+        return "\"" + value + "\"";
+    }
+
+    // JSONKeyLess
+
+    SIMPLEJSON_INLINE bool JSONKeyLess::operator()(const JSONString& lhs, const JSONString& rhs) const {
+        return lhs.value < rhs.value;
+    }
+
+    // JSONNumber
+
+    SIMPLEJSON_INLINE JSONNumber::JSONNumber() : value(JSONIntegral(0)) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE bool operator==(const JSONNumber& lhs, const JSONNumber& rhs) {
+        return lhs.value == rhs.value;
+    }
+
+    SIMPLEJSON_INLINE bool operator!=(const JSONNumber& lhs, const JSONNumber& rhs) {
+        return !(lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE bool operator<(const JSONNumber& lhs, const JSONNumber& rhs) {
+        // FIXME: find a better way to implement this method!!!
+        // std::variant::operator< and operator > do not behave the way we need
+        auto& lhsValue = lhs.value;
+        auto& rhsValue = rhs.value;
+
+        if (std::holds_alternative<JSONFloating>(lhsValue) && std::holds_alternative<JSONFloating>(rhsValue)) { 
+            return std::get<JSONFloating>(lhsValue) < std::get<JSONFloating>(rhsValue);
+        }
+        else if (std::holds_alternative<JSONFloating>(lhsValue) && std::holds_alternative<JSONIntegral>(rhsValue)) { 
+            return std::get<JSONFloating>(lhsValue) < std::get<JSONIntegral>(rhsValue);
+        }
+        else if (std::holds_alternative<JSONIntegral>(lhsValue) && std::holds_alternative<JSONFloating>(rhsValue)) { 
+            return std::get<JSONIntegral>(lhsValue) < std::get<JSONFloating>(rhsValue);
+        }
+        else if (std::holds_alternative<JSONIntegral>(lhsValue) && std::holds_alternative<JSONIntegral>(rhsValue)) { 
+            return std::get<JSONIntegral>(lhsValue) < std::get<JSONIntegral>(rhsValue);
+        }
+        else {
+            // should not get here
+            throw JSONException("Unexpected comparison on JSONNumber");
+        }
+    }
+
+    SIMPLEJSON_INLINE bool operator<=(const JSONNumber& lhs, const JSONNumber& rhs) {
+        return (lhs < rhs) || (lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE bool operator>(const JSONNumber& lhs, const JSONNumber& rhs) {
+        // FIXME: find a better way to implement this method!!!
+        // std::variant::operator< and operator > do not behave the way we need
+        auto& lhsValue = lhs.value;
+        auto& rhsValue = rhs.value;
+        
+        if (std::holds_alternative<JSONFloating>(lhsValue) && std::holds_alternative<JSONFloating>(rhsValue)) { 
+            return std::get<JSONFloating>(lhsValue) > std::get<JSONFloating>(rhsValue);
+        }
+        else if (std::holds_alternative<JSONFloating>(lhsValue) && std::holds_alternative<JSONIntegral>(rhsValue)) { 
+            return std::get<JSONFloating>(lhsValue) > std::get<JSONIntegral>(rhsValue);
+        }
+        else if (std::holds_alternative<JSONIntegral>(lhsValue) && std::holds_alternative<JSONFloating>(rhsValue)) { 
+            return std::get<JSONIntegral>(lhsValue) > std::get<JSONFloating>(rhsValue);
+        }
+        else if (std::holds_alternative<JSONIntegral>(lhsValue) && std::holds_alternative<JSONIntegral>(rhsValue)) { 
+            return std::get<JSONIntegral>(lhsValue) > std::get<JSONIntegral>(rhsValue);
+        }
+        else {
+            // should not get here
+            throw JSONException("Unexpected comparison on JSONNumber");
+        }
+    }
+
+    SIMPLEJSON_INLINE bool operator>=(const JSONNumber& lhs, const JSONNumber& rhs) {
+        return (lhs > rhs) || (lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE bool JSONNumber::isFloating() const {
+        return std::holds_alternative<JSONFloating>(value);
+    }
+
+    SIMPLEJSON_INLINE bool JSONNumber::isIntegral() const {
+        return std::holds_alternative<JSONIntegral>(value);
+    }
+
+    SIMPLEJSON_INLINE JSONFloating JSONNumber::getFloating() const {
+        if (std::holds_alternative<JSONFloating>(value)) {
+            return std::get<JSONFloating>(value);
+        }
+        else {
+            throw JSONException("This JSONNumber does not contain a floating point value");
+        }
+    }
+
+    SIMPLEJSON_INLINE JSONIntegral JSONNumber::getIntegral() const {
+        if (std::holds_alternative<JSONIntegral>(value)) {
+            return std::get<JSONIntegral>(value);
+        }
+        else {
+            throw JSONException("This JSONNumber does not contain a signed integral value");
+        }
+    }
+
+    SIMPLEJSON_INLINE std::string JSONNumber::toString() const {
+        std::string res;
+
+        auto toStringLambda = [&](auto&& arg) {
+            res += std::to_string(arg);
+        };
+        
+        std::visit(toStringLambda, value);
+
+        return res;
+    }
+
+    // JSONBool
+
+    SIMPLEJSON_INLINE JSONBool::JSONBool() : value(false) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONBool::JSONBool(bool val) : value(val) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE bool operator==(const JSONBool& lhs, const JSONBool& rhs) {
+        return lhs.value == rhs.value;
+    }
+
+    SIMPLEJSON_INLINE bool operator!=(const JSONBool& lhs, const JSONBool& rhs) {
+        return !(lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE bool JSONBool::getBoolean() const {
+        return value;
+    }
+
+    SIMPLEJSON_INLINE std::string JSONBool::toString() const {
+        return value ? std::string("true") : std::string("false");
+    }
+
+    // JSONNull
+
+    SIMPLEJSON_INLINE JSONNull::JSONNull() {};
+
+    SIMPLEJSON_INLINE JSONNull::JSONNull(const std::nullptr_t) {}
+
+    SIMPLEJSON_INLINE bool operator==(const JSONNull&, const JSONNull&) {
+        return true;
+    }
+
+    SIMPLEJSON_INLINE bool operator!=(const JSONNull&, const JSONNull&) {
+        return false;
+    }
+
+    SIMPLEJSON_INLINE std::string JSONNull::toString() const {
+        return std::string("null");
+    }
+
+    // JSONArray
+
+    SIMPLEJSON_INLINE JSONArray::JSONArray() : value(std::vector<JSONObject>{}) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONArray::JSONArray(const std::initializer_list<JSONObject> list) : value(std::vector<JSONObject>{}) { 
+        FUNCTRACE 
+        
+        for (auto& elem : list) {
+            append(elem);
+        }
+    }
+
+    SIMPLEJSON_INLINE JSONArray::JSONArray(const JSONArray& other) : value(other.value), indexes(other.indexes) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONArray& JSONArray::operator=(const JSONArray& other) {
+        FUNCTRACE
+
+        if (this != &other) {
+            value = other.value;
+            indexes = other.indexes;
+            packedElementCache.reset();
+        }
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE void JSONArray::appendNumber(const JSONNumber& num) {
+        packedElementCache.reset();
+
+        if (std::holds_alternative<std::vector<JSONIntegral>>(value) && num.isIntegral()) {
+            std::get<std::vector<JSONIntegral>>(value).push_back(num.getIntegral());
+        }
+        else if (std::holds_alternative<std::vector<JSONFloating>>(value) && num.isFloating()) {
+            std::get<std::vector<JSONFloating>>(value).push_back(num.getFloating());
+        }
+        else if (std::holds_alternative<std::vector<JSONObject>>(value) && std::get<std::vector<JSONObject>>(value).empty()) {
+            // the first element decides whether the array starts out packed
+            if (num.isIntegral()) {
+                value = std::vector<JSONIntegral>{num.getIntegral()};
+            }
+            else {
+                value = std::vector<JSONFloating>{num.getFloating()};
+            }
+        }
+        else {
+            unpack();
+            std::get<std::vector<JSONObject>>(value).emplace_back(num);
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONArray::unpack() {
+        if (std::holds_alternative<std::vector<JSONObject>>(value)) {
+            return;
+        }
+
+        packedElementCache.reset();
+
+        std::vector<JSONObject> unpacked;
+        unpacked.reserve(size());
+
+        forEach([&](const JSONObject& elem) { unpacked.push_back(elem); });
+
+        value = std::move(unpacked);
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONArray::pop() {
+        FUNCTRACE
+
+        if (!indexes.empty() && size() > 0) {
+            updateIndexes(size() - 1, true);
+        }
+
+        std::visit([](auto& vec) { vec.pop_back(); }, value);
+        packedElementCache.reset();
+        return;
+    }
+
+    SIMPLEJSON_INLINE JSONObject& JSONArray::operator[](const size_t index) {
+        if (index >= size()) {
+            throw JSONException("JSONArray operator[] index out of range");
+        }
+        else {
+            unpack();
+            return std::get<std::vector<JSONObject>>(value)[index];
+        }
+    }
+
+    SIMPLEJSON_INLINE const JSONObject& JSONArray::operator[](const size_t index) const {
+        if (index >= size()) {
+            throw JSONException("JSONArray operator[] index out of range");
+        }
+        else if (isPacked()) {
+            return packedElements()[index];
+        }
+        else {
+            return std::get<std::vector<JSONObject>>(value)[index];
+        }
+    }
+
+    SIMPLEJSON_INLINE const std::vector<JSONObject>& JSONArray::packedElements() const {
+        std::shared_ptr<const std::vector<JSONObject>> cache = std::atomic_load(&packedElementCache);
+
+        if (!cache) {
+            std::vector<JSONObject> elements;
+            elements.reserve(size());
+            forEach([&](const JSONObject& elem) { elements.push_back(elem); });
+
+            // when several readers build the cache at once, the first one to publish it wins
+            std::shared_ptr<const std::vector<JSONObject>> built = std::make_shared<const std::vector<JSONObject>>(std::move(elements));
+
+            if (std::atomic_compare_exchange_strong(&packedElementCache, &cache, built)) {
+                cache = built;
+            }
+        }
+
+        // the array keeps the cache alive until its next change
+        return *cache;
+    }
+
+    SIMPLEJSON_INLINE JSONObject JSONArray::get(const size_t index) const {
+        if (index >= size()) {
+            throw JSONException("JSONArray get index out of range");
+        }
+        else if (std::holds_alternative<std::vector<JSONIntegral>>(value)) {
+            return JSONObject(std::get<std::vector<JSONIntegral>>(value)[index]);
+        }
+        else if (std::holds_alternative<std::vector<JSONFloating>>(value)) {
+            return JSONObject(std::get<std::vector<JSONFloating>>(value)[index]);
+        }
+        else {
+            return std::get<std::vector<JSONObject>>(value)[index];
+        }
+    }
+
+    SIMPLEJSON_INLINE bool operator==(const JSONArray& lhs, const JSONArray& rhs) {
+        if (lhs.value.index() == rhs.value.index()) {
+            return lhs.value == rhs.value;
+        }
+        else if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        else {
+            // packed and unpacked arrays with the same elements are equal
+            std::vector<JSONObject> lhsElements;
+            lhsElements.reserve(lhs.size());
+            lhs.forEach([&](const JSONObject& elem) { lhsElements.push_back(elem); });
+
+            size_t i = 0;
+            bool equal = true;
+            rhs.forEach([&](const JSONObject& elem) { equal = equal && (lhsElements[i++] == elem); });
+
+            return equal;
+        }
+    }
+
+    SIMPLEJSON_INLINE bool operator!=(const JSONArray& lhs, const JSONArray& rhs) {
+        return !(lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE JSONNumber JSONArray::sum() const {
+        FUNCTRACE
+
+        internal::NumberSum__internal total;
+
+        if (std::holds_alternative<std::vector<JSONIntegral>>(value)) {
+            auto& vec = std::get<std::vector<JSONIntegral>>(value);
+            total.addIntegrals(vec.data(), vec.size());
+        }
+        else if (std::holds_alternative<std::vector<JSONFloating>>(value)) {
+            auto& vec = std::get<std::vector<JSONFloating>>(value);
+            total.addFloatings(vec.data(), vec.size());
+        }
+        else {
+            for (auto& elem : std::get<std::vector<JSONObject>>(value)) {
+                total.add(internal::numberElement__internal(elem));
+            }
+        }
+
+        return total.result();
+    }
+
+    SIMPLEJSON_INLINE JSONNumber JSONArray::min() const {
+        FUNCTRACE
+
+        if (size() == 0) {
+            throw JSONException("Cannot call min() on an empty JSONArray");
+        }
+
+        if (std::holds_alternative<std::vector<JSONIntegral>>(value)) {
+            auto& vec = std::get<std::vector<JSONIntegral>>(value);
+            return JSONNumber(internal::minOf__internal(vec.data(), vec.size()));
+        }
+        else if (std::holds_alternative<std::vector<JSONFloating>>(value)) {
+            auto& vec = std::get<std::vector<JSONFloating>>(value);
+            return JSONNumber(internal::minOf__internal(vec.data(), vec.size()));
+        }
+        else {
+            auto& vec = std::get<std::vector<JSONObject>>(value);
+            const JSONNumber* result = &internal::numberElement__internal(vec[0]);
+
+            for (size_t i = 1; i < vec.size(); ++i) {
+                auto& num = internal::numberElement__internal(vec[i]);
+                if (num < *result) {
+                    result = &num;
+                }
+            }
+
+            return *result;
+        }
+    }
+
+    SIMPLEJSON_INLINE JSONNumber JSONArray::max() const {
+        FUNCTRACE
+
+        if (size() == 0) {
+            throw JSONException("Cannot call max() on an empty JSONArray");
+        }
+
+        if (std::holds_alternative<std::vector<JSONIntegral>>(value)) {
+            auto& vec = std::get<std::vector<JSONIntegral>>(value);
+            return JSONNumber(internal::maxOf__internal(vec.data(), vec.size()));
+        }
+        else if (std::holds_alternative<std::vector<JSONFloating>>(value)) {
+            auto& vec = std::get<std::vector<JSONFloating>>(value);
+            return JSONNumber(internal::maxOf__internal(vec.data(), vec.size()));
+        }
+        else {
+            auto& vec = std::get<std::vector<JSONObject>>(value);
+            const JSONNumber* result = &internal::numberElement__internal(vec[0]);
+
+            for (size_t i = 1; i < vec.size(); ++i) {
+                auto& num = internal::numberElement__internal(vec[i]);
+                if (num > *result) {
+                    result = &num;
+                }
+            }
+
+            return *result;
+        }
+    }
+
+    SIMPLEJSON_INLINE JSONFloating JSONArray::mean() const {
+        FUNCTRACE
+
+        if (size() == 0) {
+            throw JSONException("Cannot call mean() on an empty JSONArray");
+        }
+
+        JSONNumber total = sum();
+        JSONFloating totalAsFloating = total.isIntegral() ? JSONFloating(total.getIntegral()) : total.getFloating();
+
+        return totalAsFloating / JSONFloating(size());
+    }
+
+    SIMPLEJSON_INLINE std::vector<size_t> JSONArray::histogram(const JSONFloating lowerBound, const JSONFloating upperBound, const size_t bucketCount) const {
+        FUNCTRACE
+
+        if (bucketCount == 0 || !(lowerBound < upperBound)) {
+            throw JSONException("JSONArray histogram requires at least one bucket and lowerBound < upperBound");
+        }
+
+        std::vector<size_t> buckets(bucketCount, 0);
+        JSONFloating scale = JSONFloating(bucketCount) / (upperBound - lowerBound);
+
+        auto countValue = [&](JSONFloating val) {
+            if (val >= lowerBound && val <= upperBound) {
+                size_t bucket = size_t((val - lowerBound) * scale);
+                ++buckets[std::min(bucket, bucketCount - 1)];
+            }
+        };
+
+        if (std::holds_alternative<std::vector<JSONIntegral>>(value)) {
+            for (auto val : std::get<std::vector<JSONIntegral>>(value)) {
+                countValue(JSONFloating(val));
+            }
+        }
+        else if (std::holds_alternative<std::vector<JSONFloating>>(value)) {
+            for (auto val : std::get<std::vector<JSONFloating>>(value)) {
+                countValue(val);
+            }
+        }
+        else {
+            for (auto& elem : std::get<std::vector<JSONObject>>(value)) {
+                auto& num = internal::numberElement__internal(elem);
+                countValue(num.isIntegral() ? JSONFloating(num.getIntegral()) : num.getFloating());
+            }
+        }
+
+        return buckets;
+    }
+
+    SIMPLEJSON_INLINE void JSONArray::buildIndex(const JSONPointer& keyPath, const bool sorted) {
+        FUNCTRACE
+
+        dropIndex(keyPath);
+        indexes.push_back(KeyIndex{keyPath, sorted, {}, {}, {}});
+
+        KeyIndex& index = indexes.back();
+        size_t position = 0;
+
+        JSONObject scratch;
+
+        forEach([&](const JSONObject& elem) {
+            const JSONObject* key = index.keyPath.resolve(elem, scratch);
+
+            if (key && key->isString()) {
+                index.hashed[key->toString()].push_back(position);
+                if (index.sorted) {
+                    index.sortedStrings.emplace(key->asString(), position);
+                }
+            }
+            else if (key && key->isNumber()) {
+                index.hashed[key->toString()].push_back(position);
+                if (index.sorted) {
+                    index.sortedNumbers.emplace(key->asNumber(), position);
+                }
+            }
+
+            ++position;
+        });
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONArray::dropIndex(const JSONPointer& keyPath) {
+        indexes.erase(std::remove_if(indexes.begin(), indexes.end(), [&](const KeyIndex& index) { return index.keyPath == keyPath; }), indexes.end());
+        return;
+    }
+
+    SIMPLEJSON_INLINE bool JSONArray::hasIndex(const JSONPointer& keyPath) const {
+        return std::any_of(indexes.begin(), indexes.end(), [&](const KeyIndex& index) { return index.keyPath == keyPath; });
+    }
+
+    SIMPLEJSON_INLINE const JSONArray::KeyIndex& JSONArray::getIndex(const JSONPointer& keyPath) const {
+        for (auto& index : indexes) {
+            if (index.keyPath == keyPath) {
+                return index;
+            }
+        }
+
+        std::string errorMessage = "No index was built for key path \"" + keyPath.toString() + "\"";
+        throw JSONException(errorMessage.c_str());
+    }
+
+    SIMPLEJSON_INLINE std::vector<size_t> JSONArray::findByKey(const JSONPointer& keyPath, const JSONObject& key) const {
+        FUNCTRACE
+
+        auto& index = getIndex(keyPath);
+        auto it = index.hashed.find(key.toString());
+
+        if (it == index.hashed.end()) {
+            return {};
+        }
+
+        return it->second;
+    }
+
+    SIMPLEJSON_INLINE std::vector<size_t> JSONArray::findByKeyRange(const JSONPointer& keyPath, const JSONObject& lowerKey, const JSONObject& upperKey) const {
+        FUNCTRACE
+
+        auto& index = getIndex(keyPath);
+
+        if (!index.sorted) {
+            throw JSONException("findByKeyRange requires an index built with sorted = true");
+        }
+
+        std::vector<size_t> result;
+
+        if (lowerKey.isString() && upperKey.isString()) {
+            auto end = index.sortedStrings.upper_bound(upperKey.asString());
+            for (auto it = index.sortedStrings.lower_bound(lowerKey.asString()); it != end; ++it) {
+                result.push_back(it->second);
+            }
+        }
+        else if (lowerKey.isNumber() && upperKey.isNumber()) {
+            auto end = index.sortedNumbers.upper_bound(upperKey.asNumber());
+            for (auto it = index.sortedNumbers.lower_bound(lowerKey.asNumber()); it != end; ++it) {
+                result.push_back(it->second);
+            }
+        }
+        else {
+            throw JSONException("findByKeyRange bounds must both be strings or both be numbers");
+        }
+
+        return result;
+    }
+
+    SIMPLEJSON_INLINE void JSONArray::sortBy(const JSONPointer& keyPath, const SortOrder order, const size_t threadCount) {
+        FUNCTRACE
+
+        bool descending = order == SortOrder::DESCENDING;
+        packedElementCache.reset();
+
+        if (isPacked()) {
+            if (!keyPath.getTokens().empty()) {
+                throw JSONException("sortBy failed, elements of a numeric array have no fields to sort by");
+            }
+
+            std::visit([&](auto& vec) {
+                using ElementType = typename std::decay_t<decltype(vec)>::value_type;
+                internal::parallelStableSort__internal(vec, [&](const ElementType& lhs, const ElementType& rhs) { 
+                    return descending ? rhs < lhs : lhs < rhs; 
+                }, threadCount);
+            }, value);
+        }
+        else {
+            auto& elements = std::get<std::vector<JSONObject>>(value);
+
+            // decorate: resolve every key once instead of on every comparison
+            std::vector<std::pair<const JSONObject*, size_t>> keys;
+            keys.reserve(elements.size());
+            std::deque<JSONObject> packedKeys;
+            JSONObject scratch;
+
+            for (size_t i = 0; i < elements.size(); ++i) {
+                const JSONObject* key = keyPath.resolve(elements[i], scratch);
+
+                // keys taken from packed arrays live in scratch, which the next element overwrites
+                if (key == &scratch) {
+                    packedKeys.push_back(scratch);
+                    key = &packedKeys.back();
+                }
+
+                if (!key || !(key->isString() || key->isNumber())) {
+                    std::string errorMessage = "sortBy failed, element " + std::to_string(i) + " has no string or number at \"" + keyPath.toString() + "\"";
+                    throw JSONException(errorMessage.c_str());
+                }
+
+                if (!keys.empty() && key->isString() != keys.front().first->isString()) {
+                    throw JSONException("sortBy failed, keys must be all strings or all numbers");
+                }
+
+                keys.push_back({key, i});
+            }
+
+            if (!keys.empty() && keys.front().first->isString()) {
+                internal::parallelStableSort__internal(keys, [&](const auto& lhs, const auto& rhs) {
+                    return descending ? rhs.first->asString() < lhs.first->asString() : lhs.first->asString() < rhs.first->asString();
+                }, threadCount);
+            }
+            else {
+                internal::parallelStableSort__internal(keys, [&](const auto& lhs, const auto& rhs) {
+                    return descending ? rhs.first->asNumber() < lhs.first->asNumber() : lhs.first->asNumber() < rhs.first->asNumber();
+                }, threadCount);
+            }
+
+            // undecorate: move every element into its sorted position
+            std::vector<JSONObject> sorted;
+            sorted.reserve(elements.size());
+
+            for (auto& key : keys) {
+                sorted.push_back(std::move(elements[key.second]));
+            }
+
+            elements = std::move(sorted);
+        }
+
+        rebuildIndexes();
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONArray::updateIndexes(const size_t position, const bool isRemoval) {
+        // packed elements are materialized only for the duration of the update
+        JSONObject packedElement;
+        const JSONObject* elem = &packedElement;
+
+        if (std::holds_alternative<std::vector<JSONIntegral>>(value)) {
+            packedElement = std::get<std::vector<JSONIntegral>>(value)[position];
+        }
+        else if (std::holds_alternative<std::vector<JSONFloating>>(value)) {
+            packedElement = std::get<std::vector<JSONFloating>>(value)[position];
+        }
+        else {
+            elem = &std::get<std::vector<JSONObject>>(value)[position];
+        }
+
+        JSONObject scratch;
+
+        for (auto& index : indexes) {
+            const JSONObject* key = index.keyPath.resolve(*elem, scratch);
+
+            if (!key || !(key->isString() || key->isNumber())) {
+                continue;
+            }
+
+            auto& positions = index.hashed[key->toString()];
+
+            if (isRemoval) {
+                positions.erase(std::remove(positions.begin(), positions.end(), position), positions.end());
+                if (positions.empty()) {
+                    index.hashed.erase(key->toString());
+                }
+            }
+            else {
+                positions.push_back(position);
+            }
+
+            if (!index.sorted) {
+                continue;
+            }
+
+            auto updateSorted = [&](auto& sortedKeys, const auto& sortKey) {
+                if (isRemoval) {
+                    auto range = sortedKeys.equal_range(sortKey);
+                    for (auto it = range.first; it != range.second; ++it) {
+                        if (it->second == position) {
+                            sortedKeys.erase(it);
+                            break;
+                        }
+                    }
+                }
+                else {
+                    sortedKeys.emplace(sortKey, position);
+                }
+            };
+
+            if (key->isString()) {
+                updateSorted(index.sortedStrings, key->asString());
+            }
+            else {
+                updateSorted(index.sortedNumbers, key->asNumber());
+            }
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONArray::rebuildIndexes() {
+        std::vector<KeyIndex> oldIndexes = std::move(indexes);
+        indexes.clear();
+
+        for (auto& index : oldIndexes) {
+            buildIndex(index.keyPath, index.sorted);
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE size_t JSONArray::size() const {
+        return std::visit([](auto& vec) { return vec.size(); }, value);
+    }
+
+    SIMPLEJSON_INLINE void JSONArray::clear() {
+        value = std::vector<JSONObject>{};
+        packedElementCache.reset();
+        rebuildIndexes();
+        return;
+    }
+
+    SIMPLEJSON_INLINE bool JSONArray::isPacked() const {
+        return !std::holds_alternative<std::vector<JSONObject>>(value);
+    }
+
+    SIMPLEJSON_INLINE std::string JSONArray::toString() const {
+        std::string res;
+        internal::DocumentPrinter__internal<std::string>(res, nullptr, "").print(*this);
+        return res;
+    }
+
+    SIMPLEJSON_INLINE std::string JSONArray::toIndentedString(std::string& currentIndentation, const std::string& indentString) const {
+        PrettyPrintOptions options;
+        options.indentString = indentString;
+
+        std::string res;
+        internal::DocumentPrinter__internal<std::string>(res, &options, currentIndentation).print(*this);
+        return res;
+    }
+
+    // JSONObject
+
+    SIMPLEJSON_INLINE JSONObject::JSONObject() : value(JSONMap{}) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONObject::~JSONObject() {
+        // every object taken off the stack has lost its nested values already, so its own destructor stays shallow
+        std::vector<JSONObject> nested;
+        takeNestedValues(*this, nested);
+
+        while (!nested.empty()) {
+            JSONObject obj = std::move(nested.back());
+            nested.pop_back();
+            takeNestedValues(obj, nested);
+        }
+    }
+
+    SIMPLEJSON_INLINE void JSONObject::takeNestedValues(JSONObject& obj, std::vector<JSONObject>& nested) {
+        auto hasChildren = [](const JSONObject& child) {
+            if (auto* arr = std::get_if<JSONArray>(&child.value)) {
+                auto* elems = std::get_if<std::vector<JSONObject>>(&arr->value);
+                return elems != nullptr && !elems->empty();
+            }
+            else if (auto* map = std::get_if<JSONMap>(&child.value)) {
+                return !map->empty();
+            }
+            return false;
+        };
+
+        if (auto* arr = std::get_if<JSONArray>(&obj.value)) {
+            if (auto* elems = std::get_if<std::vector<JSONObject>>(&arr->value)) {
+                for (JSONObject& elem : *elems) {
+                    if (hasChildren(elem)) {
+                        nested.push_back(std::move(elem));
+                    }
+                }
+            }
+        }
+        else if (auto* map = std::get_if<JSONMap>(&obj.value)) {
+            for (auto& field : *map) {
+                if (hasChildren(field.second)) {
+                    nested.push_back(std::move(field.second));
+                }
+            }
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE JSONObject::JSONObject(const char* str) : value(JSONString(str)) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONObject::JSONObject(const std::string& str) : value(JSONString(str)) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONObject::JSONObject(const JSONString& str) : value(str) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONObject::JSONObject(const JSONNumber& num) : value(num) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONObject::JSONObject(const bool b) : value(JSONBool(b)) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONObject::JSONObject(const JSONBool b) : value(b) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONObject::JSONObject(const std::nullptr_t) : value(JSONNull{}) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONObject::JSONObject(const JSONNull n) : value(n) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONObject::JSONObject(const JSONArray& arr) : value(arr) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONObject::JSONObject(const std::initializer_list<std::pair<const JSONString, JSONObject>> list) : value(list) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE void JSONObject::pop() {
+        if (std::holds_alternative<JSONArray>(value)) {
+            auto& arr = std::get<JSONArray>(value);
+            arr.pop();
+            return;
+        }
+        else {
+            throw JSONException("Cannot pop. Current JSONObject does not hold an array");
+        }
+    }
+
+    SIMPLEJSON_INLINE JSONObject& JSONObject::operator[](const size_t index) {
+        if (std::holds_alternative<JSONArray>(value)) {
+            auto& arr = std::get<JSONArray>(value);
+            return arr[index];
+        }
+        else {
+            throw JSONException("Operator[] failed, this JSONObject is not an array");
+        }
+    }
+
+    SIMPLEJSON_INLINE const JSONObject& JSONObject::operator[](const size_t index) const {
+        if (std::holds_alternative<JSONArray>(value)) {
+            auto& arr = std::get<JSONArray>(value);
+            return arr[index];
+        }
+        else {
+            throw JSONException("Operator[] failed, this JSONObject is not an array");
+        }
+    }
+
+    SIMPLEJSON_INLINE JSONObject JSONObject::get(const size_t index) const {
+        if (std::holds_alternative<JSONArray>(value)) {
+            return std::get<JSONArray>(value).get(index);
+        }
+        else {
+            throw JSONException("get failed, this JSONObject is not an array");
+        }
+    }
+
+    SIMPLEJSON_INLINE size_t JSONObject::size() const {
+        if (std::holds_alternative<JSONArray>(value)) {
+            auto& arr = std::get<JSONArray>(value);
+            return arr.size();
+        }
+        else {
+            throw JSONException("Current JSONObject is not an array, cannot call size()");
+        }
+    }
+
+    SIMPLEJSON_INLINE void JSONObject::clear() {
+        if (std::holds_alternative<JSONArray>(value)) {
+            auto& arr = std::get<JSONArray>(value);
+            return arr.clear();
+        }
+        else {
+            throw JSONException("Current JSONObject is not an array, cannot call clear()");
+        }
+    }
+
+    SIMPLEJSON_INLINE void JSONObject::removeField(const JSONString& key) {
+        if (std::holds_alternative<JSONMap>(value)) {
+            auto& map = std::get<JSONMap>(value);
+
+            auto it = map.find(key);
+            if (it != std::end(map)) {
+                map.erase(it);
+            }
+        }
+        else {
+            throw JSONException("Removing field failed, this JSONObject is not a map");
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE size_t JSONObject::getNumberOfFields() const {
+        if (std::holds_alternative<JSONMap>(value)) {
+            auto& map = std::get<JSONMap>(value);
+            return map.size();
+        }
+        else {
+            throw JSONException("Removing field failed, this JSONObject is not a map");
+        }
+    }
+
+    SIMPLEJSON_INLINE JSONObject& JSONObject::operator[](const JSONString& key) {
+        if (std::holds_alternative<JSONMap>(value)) {
+            auto& map = std::get<JSONMap>(value);
+            return map[key];
+        }
+        else {
+            throw JSONException("Operator[] failed, this JSONObject is not a map");
+        }
+    }
+
+    SIMPLEJSON_INLINE const JSONObject& JSONObject::operator[](const JSONString& key) const {
+        if (std::holds_alternative<JSONMap>(value)) {
+            auto& map = std::get<JSONMap>(value);
+            return map.at(key);
+        }
+        else {
+            throw JSONException("Operator[] failed, this JSONObject is not a map");
+        }
+    }   
+
+    SIMPLEJSON_INLINE JSONObject& JSONObject::operator[](const JSONKey& key) {
+        if (std::holds_alternative<JSONMap>(value)) {
+            auto& map = std::get<JSONMap>(value);
+            auto it = map.find(key);
+
+            if (it == map.end()) {
+                it = map.emplace(JSONString(std::string(key.name)), JSONObject()).first;
+            }
+
+            return it->second;
+        }
+        else {
+            throw JSONException("Operator[] failed, this JSONObject is not a map");
+        }
+    }
+
+    SIMPLEJSON_INLINE const JSONObject& JSONObject::operator[](const JSONKey& key) const {
+        if (std::holds_alternative<JSONMap>(value)) {
+            auto& map = std::get<JSONMap>(value);
+            auto it = map.find(key);
+
+            if (it == map.end()) {
+                throw JSONException("Operator[] failed, key not found in this JSONObject");
+            }
+
+            return it->second;
+        }
+        else {
+            throw JSONException("Operator[] failed, this JSONObject is not a map");
+        }
+    }
+
+    SIMPLEJSON_INLINE const JSONObject* JSONObject::find(std::string_view key) const {
+        const auto& map = asMap();
+        auto it = map.find(key);
+        return it == map.end() ? nullptr : &it->second;
+    }
+
+    SIMPLEJSON_INLINE const JSONObject* JSONObject::find(const JSONKey& key) const {
+        const auto& map = asMap();
+        auto it = map.find(key);
+        return it == map.end() ? nullptr : &it->second;
+    }
+
+    SIMPLEJSON_INLINE bool JSONObject::isString() const {
+        return std::holds_alternative<JSONString>(value);
+    }
+
+    SIMPLEJSON_INLINE bool JSONObject::isNumber() const {
+        return std::holds_alternative<JSONNumber>(value);
+    }
+
+    SIMPLEJSON_INLINE bool JSONObject::isBool() const {
+        return std::holds_alternative<JSONBool>(value);
+    }
+
+    SIMPLEJSON_INLINE bool JSONObject::isNull() const {
+        return std::holds_alternative<JSONNull>(value);
+    }
+
+    SIMPLEJSON_INLINE bool JSONObject::isArray() const {
+        return std::holds_alternative<JSONArray>(value);
+    }
+
+    SIMPLEJSON_INLINE bool JSONObject::isMap() const {
+        return std::holds_alternative<JSONMap>(value);
+    }
+
+    SIMPLEJSON_INLINE const JSONString& JSONObject::asString() const {
+        if (std::holds_alternative<JSONString>(value)) {
+            return std::get<JSONString>(value);
+        }
+        else {
+            throw JSONException("This JSONObject does not hold a JSONString");
+        }
+    }
+
+    SIMPLEJSON_INLINE const JSONNumber& JSONObject::asNumber() const {
+        if (std::holds_alternative<JSONNumber>(value)) {
+            return std::get<JSONNumber>(value);
+        }
+        else {
+            throw JSONException("This JSONObject does not hold a JSONNumber");
+        }
+    }
+
+    SIMPLEJSON_INLINE const JSONBool& JSONObject::asBool() const {
+        if (std::holds_alternative<JSONBool>(value)) {
+            return std::get<JSONBool>(value);
+        }
+        else {
+            throw JSONException("This JSONObject does not hold a JSONBool");
+        }
+    }
+
+    SIMPLEJSON_INLINE const JSONArray& JSONObject::asArray() const {
+        if (std::holds_alternative<JSONArray>(value)) {
+            return std::get<JSONArray>(value);
+        }
+        else {
+            throw JSONException("This JSONObject does not hold a JSONArray");
+        }
+    }
+
+    SIMPLEJSON_INLINE JSONArray& JSONObject::asArray() {
+        if (std::holds_alternative<JSONArray>(value)) {
+            return std::get<JSONArray>(value);
+        }
+        else {
+            throw JSONException("This JSONObject does not hold a JSONArray");
+        }
+    }
+
+    SIMPLEJSON_INLINE const JSONMap& JSONObject::asMap() const {
+        if (std::holds_alternative<JSONMap>(value)) {
+            return std::get<JSONMap>(value);
+        }
+        else {
+            throw JSONException("This JSONObject is not a map");
+        }
+    }
+
+    SIMPLEJSON_INLINE JSONMap& JSONObject::asMap() {
+        if (std::holds_alternative<JSONMap>(value)) {
+            return std::get<JSONMap>(value);
+        }
+        else {
+            throw JSONException("This JSONObject is not a map");
+        }
+    }
+
+    SIMPLEJSON_INLINE bool operator==(const JSONObject& lhs, const JSONObject& rhs) {
+        return lhs.value == rhs.value;
+    }
+
+    SIMPLEJSON_INLINE bool operator!=(const JSONObject& lhs, const JSONObject& rhs) {
+        return !(lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE bool operator<(const JSONObject& lhs, const JSONObject& rhs) {
+        auto& lhsValue = lhs.value;
+        auto& rhsValue = rhs.value;
+        
+        if (std::holds_alternative<JSONString>(lhsValue) && std::holds_alternative<JSONString>(rhsValue)) {
+            return std::get<JSONString>(lhsValue) < std::get<JSONString>(rhsValue);
+        }
+        else if (std::holds_alternative<JSONNumber>(lhsValue) && std::holds_alternative<JSONNumber>(rhsValue)) {
+            return std::get<JSONNumber>(lhsValue) < std::get<JSONNumber>(rhsValue);
+        }
+        else {
+            throw JSONException("JSONObjects must hold JSONString or JSONNumber to use operator<");
+        }
+    }
+
+    SIMPLEJSON_INLINE bool operator<=(const JSONObject& lhs, const JSONObject& rhs) {
+        return (lhs < rhs) || (lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE bool operator>(const JSONObject& lhs, const JSONObject& rhs) {
+        auto& lhsValue = lhs.value;
+        auto& rhsValue = rhs.value;
+        
+        if (std::holds_alternative<JSONString>(lhsValue) && std::holds_alternative<JSONString>(rhsValue)) {
+            return std::get<JSONString>(lhsValue) > std::get<JSONString>(rhsValue);
+        }
+        else if (std::holds_alternative<JSONNumber>(lhsValue) && std::holds_alternative<JSONNumber>(rhsValue)) {
+            return std::get<JSONNumber>(lhsValue) > std::get<JSONNumber>(rhsValue);
+        }
+        else {
+            throw JSONException("JSONObjects must hold JSONString or JSONNumber to use operator>");
+        }
+    }
+
+    SIMPLEJSON_INLINE bool operator>=(const JSONObject& lhs, const JSONObject& rhs) {
+        return (lhs > rhs) || (lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE std::string JSONObject::toString() const {
+        std::string res;
+        internal::DocumentPrinter__internal<std::string>(res, nullptr, "").print(*this);
+        return res;
+    }
+
+    SIMPLEJSON_INLINE std::string JSONObject::toIndentedString(std::string& currentIndentation, const std::string& indentString) const {
+        PrettyPrintOptions options;
+        options.indentString = indentString;
+
+        std::string res;
+        internal::DocumentPrinter__internal<std::string>(res, &options, currentIndentation).print(*this);
+        return res;
+    }
+
+    // JSONTokenizer
+
+    SIMPLEJSON_INLINE JSONTokenizer::JSONTokenizer() { 
+        reset(); 
+    }
+
+    SIMPLEJSON_INLINE void JSONTokenizer::reset() {
+        syntax.reset();
+        lexeme = Lexeme::NONE;
+        escaped = false;
+        lexemeStart = 0;
+        lexemeOffset = 0;
+        pending.clear();
+        consumed = 0;
+        return;
+    }
+
+    SIMPLEJSON_INLINE bool JSONTokenizer::isComplete() const {
+        return syntax.isComplete() && lexeme == Lexeme::NONE;
+    }
+
+    SIMPLEJSON_INLINE size_t JSONTokenizer::getDepth() const {
+        return syntax.containers.size();
+    }
+
+    SIMPLEJSON_INLINE bool JSONTokenizer::nextToken(std::string_view chunk, size_t& pos, JSONToken& token) {
+        while (pos < chunk.size()) {
+            if (lexeme == Lexeme::NONE) {
+                char c = chunk[pos];
+
+                if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                    pos = internal::skipWhitespace__internal(chunk, pos + 1);
+                    continue;
+                }
+
+                // the previous token has been handed out by now, its buffered text is no longer needed
+                lexemeStart = pos;
+                lexemeOffset = consumed + pos;
+                pending.clear();
+
+                switch (c) {
+                    case '{':
+                    case '[':
+                    case '}':
+                    case ']':
+                        syntax.structural(c, lexemeOffset);
+                        token = {c == '{' ? JSONTokenType::BEGIN_OBJECT : c == '[' ? JSONTokenType::BEGIN_ARRAY 
+                                 : c == '}' ? JSONTokenType::END_OBJECT : JSONTokenType::END_ARRAY, chunk.substr(pos++, 1)};
+                        return true;
+                    case ',':
+                    case ':':
+                        syntax.structural(c, lexemeOffset);
+                        ++pos;
+                        continue;
+                    case '"':
+                        syntax.beginString(lexemeOffset);
+                        lexeme = Lexeme::STRING;
+                        escaped = false;
+                        ++pos;
+                        break;
+                    case 't':
+                    case 'f':
+                    case 'n':
+                        syntax.beginValue(lexemeOffset);
+                        lexeme = Lexeme::LITERAL;
+                        ++pos;
+                        break;
+                    default:
+                        if (c != '-' && !(c >= '0' && c <= '9')) {
+                            syntax.unexpected(lexemeOffset);
+                        }
+                        syntax.beginValue(lexemeOffset);
+                        lexeme = Lexeme::NUMBER;
+                        ++pos;
+                        break;
+                }
+            }
+
+            // continue the current lexeme, possibly started in an earlier chunk
+            bool ended = false;
+
+            if (lexeme == Lexeme::STRING) {
+                for (; pos < chunk.size(); ++pos) {
+                    if (escaped) {
+                        escaped = false;
+                        continue;
+                    }
+
+                    pos = internal::findQuoteOrBackslash__internal(chunk, pos);
+
+                    if (pos == chunk.size()) {
+                        break;
+                    }
+                    else if (chunk[pos] == '\\') {
+                        escaped = true;
+                    }
+                    else if (chunk[pos] == '"') {
+                        ++pos;
+                        ended = true;
+                        break;
+                    }
+                }
+            }
+            else if (lexeme == Lexeme::NUMBER) {
+                while (pos < chunk.size() && ((chunk[pos] >= '0' && chunk[pos] <= '9') || chunk[pos] == '.' || chunk[pos] == '-' 
+                                              || chunk[pos] == '+' || chunk[pos] == 'e' || chunk[pos] == 'E')) {
+                    ++pos;
+                }
+                ended = pos < chunk.size();
+            }
+            else {
+                while (pos < chunk.size() && chunk[pos] >= 'a' && chunk[pos] <= 'z') {
+                    ++pos;
+                }
+                ended = pos < chunk.size();
+            }
+
+            if (!ended) {
+                pending.append(chunk.substr(lexemeStart));
+                return false;
+            }
+
+            if (pending.empty()) {
+                token = completeLexeme(chunk.substr(lexemeStart, pos - lexemeStart));
+            }
+            else {
+                pending.append(chunk.substr(lexemeStart, pos - lexemeStart));
+                token = completeLexeme(pending);
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    SIMPLEJSON_INLINE JSONToken JSONTokenizer::completeLexeme(std::string_view text) {
+        Lexeme completed = lexeme;
+        lexeme = Lexeme::NONE;
+
+        if (completed == Lexeme::STRING) {
+            internal::validateString__internal(text, 0, lexemeOffset);
+            bool isKey = syntax.endString();
+            return {isKey ? JSONTokenType::KEY : JSONTokenType::STRING, text.substr(1, text.size() - 2)};
+        }
+        else if (completed == Lexeme::NUMBER) {
+            internal::validateNumber__internal(text, 0, lexemeOffset);
+            syntax.afterValue();
+            return {JSONTokenType::NUMBER, text};
+        }
+        else {
+            internal::validateLiteral__internal(text, lexemeOffset);
+            syntax.afterValue();
+            return {text == "null" ? JSONTokenType::NULL_VALUE : JSONTokenType::BOOL, text};
+        }
+    }
+
+
+    // JSONStreamParser
+
+    SIMPLEJSON_INLINE JSONStreamParser::JSONStreamParser() { FUNCTRACE }
+
+    SIMPLEJSON_INLINE void JSONStreamParser::feed(std::string_view chunk) {
+        tokenizer.feed(chunk, [this](const JSONToken& token) { onToken(token); });
+        return;
+    }
+
+    SIMPLEJSON_INLINE JSONObject JSONStreamParser::finish() {
+        tokenizer.finish([this](const JSONToken& token) { onToken(token); });
+
+        JSONObject result = std::move(root);
+        tokenizer.reset();
+        root = JSONObject();
+        return result;
+    }
+
+    SIMPLEJSON_INLINE void JSONStreamParser::onToken(const JSONToken& token) {
+        switch (token.type) {
+            case JSONTokenType::BEGIN_OBJECT:
+                containers.emplace_back();
+                break;
+            case JSONTokenType::BEGIN_ARRAY:
+                containers.emplace_back(JSONArray());
+                break;
+            case JSONTokenType::END_OBJECT:
+            case JSONTokenType::END_ARRAY: {
+                JSONObject finished = std::move(containers.back());
+                containers.pop_back();
+                addValue(std::move(finished));
+                break;
+            }
+            case JSONTokenType::KEY:
+                keys.emplace_back(token.text);
+                break;
+            case JSONTokenType::STRING:
+                addValue(JSONString(std::string(token.text)));
+                break;
+            case JSONTokenType::NUMBER: {
+                std::string number(token.text);
+                bool isFloating = number.find_first_of(".eE") != std::string::npos;
+                addValue(isFloating ? JSONNumber(internal::strToJSONFloating__internal(number)) : JSONNumber(internal::strToJSONIntegral__internal(number)));
+                break;
+            }
+            case JSONTokenType::BOOL:
+                addValue(JSONBool(token.text == "true"));
+                break;
+            case JSONTokenType::NULL_VALUE:
+                addValue(JSONNull());
+                break;
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONStreamParser::setRecordHandler(std::function<void(JSONObject)> handler) {
+        recordHandler = std::move(handler);
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONStreamParser::addValue(JSONObject value) {
+        if (containers.empty()) {
+            root = std::move(value);
+        }
+        else if (recordHandler && containers.size() == 1 && containers.back().isArray()) {
+            recordHandler(std::move(value));
+        }
+        else if (containers.back().isArray()) {
+            containers.back().append(std::move(value));
+        }
+        else {
+            containers.back()[JSONString(keys.back())] = std::move(value);
+            keys.pop_back();
+        }
+        return;
+    }
+
+    // SHA256
+
+    SIMPLEJSON_INLINE SHA256::SHA256() {
+        reset();
+    }
+
+    SIMPLEJSON_INLINE void SHA256::reset() {
+        state = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        bufferSize = 0;
+        totalSize = 0;
+        return;
+    }
+
+    SIMPLEJSON_INLINE void SHA256::update(std::string_view data) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+        size_t remaining = data.size();
+        totalSize += remaining;
+
+        if (bufferSize > 0) {
+            size_t taken = std::min(remaining, buffer.size() - bufferSize);
+            std::memcpy(buffer.data() + bufferSize, bytes, taken);
+            bufferSize += taken;
+            bytes += taken;
+            remaining -= taken;
+
+            if (bufferSize < buffer.size()) {
+                return;
+            }
+
+            processBlock(buffer.data());
+            bufferSize = 0;
+        }
+
+        for (; remaining >= buffer.size(); bytes += buffer.size(), remaining -= buffer.size()) {
+            processBlock(bytes);
+        }
+
+        std::memcpy(buffer.data(), bytes, remaining);
+        bufferSize = remaining;
+        return;
+    }
+
+    SIMPLEJSON_INLINE std::array<uint8_t, 32> SHA256::finish() {
+        const uint64_t bitLength = totalSize * 8;
+
+        uint8_t padding[72] = {0x80};
+        size_t paddingSize = (bufferSize < 56 ? 56 : 120) - bufferSize;
+
+        for (size_t i = 0; i < 8; ++i) {
+            padding[paddingSize + i] = uint8_t(bitLength >> (56 - 8 * i));
+        }
+
+        update(std::string_view(reinterpret_cast<const char*>(padding), paddingSize + 8));
+
+        std::array<uint8_t, 32> digest;
+
+        for (size_t i = 0; i < 32; ++i) {
+            digest[i] = uint8_t(state[i / 4] >> (24 - 8 * (i % 4)));
+        }
+
+        return digest;
+    }
+
+    SIMPLEJSON_INLINE std::string SHA256::toHex(const std::array<uint8_t, 32>& digest) {
+        static const char* hexDigits = "0123456789abcdef";
+
+        std::string res;
+        res.reserve(64);
+
+        for (uint8_t byte : digest) {
+            res += hexDigits[byte >> 4];
+            res += hexDigits[byte & 0xF];
+        }
+
+        return res;
+    }
+
+    SIMPLEJSON_INLINE void SHA256::processBlock(const uint8_t* block) {
+        static constexpr uint32_t roundConstants[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+
+        auto rotateRight = [](const uint32_t x, const unsigned n) {
+            return (x >> n) | (x << (32 - n));
+        };
+
+        uint32_t schedule[64];
+
+        for (size_t i = 0; i < 16; ++i) {
+            schedule[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) | (uint32_t(block[4 * i + 2]) << 8) | uint32_t(block[4 * i + 3]);
+        }
+
+        for (size_t i = 16; i < 64; ++i) {
+            uint32_t s0 = rotateRight(schedule[i - 15], 7) ^ rotateRight(schedule[i - 15], 18) ^ (schedule[i - 15] >> 3);
+            uint32_t s1 = rotateRight(schedule[i - 2], 17) ^ rotateRight(schedule[i - 2], 19) ^ (schedule[i - 2] >> 10);
+            schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (size_t i = 0; i < 64; ++i) {
+            uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+            uint32_t choice = (e & f) ^ (~e & g);
+            uint32_t temp1 = h + s1 + choice + roundConstants[i] + schedule[i];
+            uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+            uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t temp2 = s0 + majority;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+        return;
+    }
+
+    // JSONWriter
+
+    SIMPLEJSON_INLINE JSONWriter::JSONWriter(std::string& out, const std::string& indentString) 
+        : stringSink(&out), streamSink(nullptr), fdSink(-1), indentString(indentString), hasChildren(false), keyWritten(false), rootWritten(false) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONWriter::JSONWriter(std::ostream& out, const std::string& indentString) 
+        : stringSink(nullptr), streamSink(&out), fdSink(-1), indentString(indentString), hasChildren(false), keyWritten(false), rootWritten(false) { FUNCTRACE }
+
+#ifdef SIMPLEJSON_HAS_MMAP
+    SIMPLEJSON_INLINE JSONWriter::JSONWriter(const int fd, const std::string& indentString) 
+        : stringSink(nullptr), streamSink(nullptr), fdSink(fd), indentString(indentString), hasChildren(false), keyWritten(false), rootWritten(false) { FUNCTRACE }
+#endif
+
+    SIMPLEJSON_INLINE JSONWriter::~JSONWriter() {
+        try {
+            flush();
+        }
+        catch (...) {}
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::startObject() {
+        beforeValue();
+        write("{");
+        containers.push_back(true);
+        hasChildren = false;
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::endObject() {
+        beforeEnd(true);
+        write("}");
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::startArray() {
+        beforeValue();
+        write("[");
+        containers.push_back(false);
+        hasChildren = false;
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::endArray() {
+        beforeEnd(false);
+        write("]");
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::key(std::string_view name) {
+        return rawKey(internal::escapeString__internal(name));
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::rawKey(std::string_view escapedName) {
+#ifndef NDEBUG
+        if (containers.empty() || !containers.back() || keyWritten) {
+            throw JSONException("JSONWriter key is only allowed inside an object, before each value");
+        }
+#endif
+
+        if (hasChildren) {
+            write(",");
+        }
+
+        if (!indentString.empty()) {
+            write("\n");
+            writeIndentation();
+        }
+
+        write("\"");
+        write(escapedName);
+        write(indentString.empty() ? "\":" : "\" : ");
+
+        hasChildren = true;
+        keyWritten = true;
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::rawString(std::string_view escapedText) {
+        beforeValue();
+        write("\"");
+        write(escapedText);
+        write("\"");
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::rawValue(std::string_view json) {
+        beforeValue();
+        write(json);
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::value(std::string_view str) {
+        beforeValue();
+        write("\"");
+        write(internal::escapeString__internal(str));
+        write("\"");
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::value(const char* str) {
+        return value(std::string_view(str));
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::value(const std::string& str) {
+        return value(std::string_view(str));
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::value(const JSONNumber& num) {
+        beforeValue();
+        write(num.toString());
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::value(const bool b) {
+        beforeValue();
+        write(b ? "true" : "false");
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::value(const std::nullptr_t) {
+        beforeValue();
+        write("null");
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONWriter& JSONWriter::value(const JSONObject& obj) {
+        beforeValue();
+
+        if (indentString.empty()) {
+            write(obj.toString());
+        }
+        else {
+            std::string currentIndentation;
+
+            for (size_t i = 0; i < containers.size(); ++i) {
+                currentIndentation += indentString;
+            }
+
+            write(obj.toIndentedString(currentIndentation, indentString));
+        }
+
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE bool JSONWriter::isComplete() const {
+        return rootWritten && containers.empty();
+    }
+
+    SIMPLEJSON_INLINE void JSONWriter::flush() {
+        if (streamSink) {
+            streamSink->write(buffer.data(), std::streamsize(buffer.size()));
+
+            if (!*streamSink) {
+                throw JSONException("Error while writing JSON to stream");
+            }
+        }
+#ifdef SIMPLEJSON_HAS_MMAP
+        else if (fdSink >= 0) {
+            size_t written = 0;
+
+            while (written < buffer.size()) {
+                ssize_t result = ::write(fdSink, buffer.data() + written, buffer.size() - written);
+
+                if (result < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+
+                    throw JSONException("Error while writing JSON to file descriptor");
+                }
+
+                written += size_t(result);
+            }
+        }
+#endif
+
+        buffer.clear();
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONWriter::beforeValue() {
+#ifndef NDEBUG
+        if (containers.empty() && rootWritten) {
+            throw JSONException("JSONWriter already holds a complete value");
+        }
+        else if (!containers.empty() && containers.back() && !keyWritten) {
+            throw JSONException("JSONWriter expected a key before a value inside an object");
+        }
+#endif
+
+        if (containers.empty()) {
+            rootWritten = true;
+        }
+        else if (!containers.back()) {
+            if (hasChildren) {
+                write(",");
+            }
+
+            if (!indentString.empty()) {
+                write("\n");
+                writeIndentation();
+            }
+
+            hasChildren = true;
+        }
+
+        keyWritten = false;
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONWriter::beforeEnd(const bool isObject) {
+#ifndef NDEBUG
+        if (containers.empty() || containers.back() != isObject || keyWritten) {
+            throw JSONException("JSONWriter end call does not match the innermost open container");
+        }
+#else
+        (void)isObject;
+#endif
+
+        containers.pop_back();
+
+        if (hasChildren && !indentString.empty()) {
+            write("\n");
+            writeIndentation();
+        }
+
+        // the closed container is itself a child of its parent
+        hasChildren = true;
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONWriter::writeIndentation() {
+        for (size_t i = 0; i < containers.size(); ++i) {
+            write(indentString);
+        }
+
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONWriter::write(std::string_view text) {
+        constexpr size_t flushThreshold = 1 << 16;
+
+        if (stringSink) {
+            stringSink->append(text);
+        }
+        else {
+            buffer.append(text);
+
+            if (buffer.size() >= flushThreshold) {
+                flush();
+            }
+        }
+
+        return;
+    }
+
+    // JSONFilter
+
+    SIMPLEJSON_INLINE JSONFilter::JSONFilter() : maxRuleDepth(0), skipDepth(0) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONFilter& JSONFilter::drop(const JSONPointer& pattern) {
+        if (pattern.getTokens().empty()) {
+            throw JSONException("JSONFilter cannot drop the root value, the output would not be JSON");
+        }
+
+        rules.push_back(Rule{pattern.getTokens(), FilterAction::DROP, JSONObject{}});
+        maxRuleDepth = std::max(maxRuleDepth, pattern.getTokens().size());
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONFilter& JSONFilter::redact(const JSONPointer& pattern, std::string_view mask) {
+        return replace(pattern, JSONString(internal::escapeString__internal(mask)));
+    }
+
+    SIMPLEJSON_INLINE JSONFilter& JSONFilter::replace(const JSONPointer& pattern, const JSONObject& replacement) {
+        rules.push_back(Rule{pattern.getTokens(), FilterAction::REPLACE, replacement});
+        maxRuleDepth = std::max(maxRuleDepth, pattern.getTokens().size());
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE void JSONFilter::feed(std::string_view chunk, JSONWriter& writer) {
+        tokenizer.feed(chunk, [&](const JSONToken& token) { onToken(token, writer); });
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONFilter::finish(JSONWriter& writer) {
+        tokenizer.finish([&](const JSONToken& token) { onToken(token, writer); });
+        writer.flush();
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONFilter::reset() {
+        tokenizer.reset();
+        path.clear();
+        skipDepth = 0;
+        return;
+    }
+
+    SIMPLEJSON_INLINE std::string JSONFilter::apply(std::string_view input) {
+        FUNCTRACE
+
+        reset();
+
+        std::string res;
+        JSONWriter writer(res);
+
+        feed(input, writer);
+        finish(writer);
+        return res;
+    }
+
+    SIMPLEJSON_INLINE void JSONFilter::onToken(const JSONToken& token, JSONWriter& writer) {
+        const bool opensContainer = token.type == JSONTokenType::BEGIN_OBJECT || token.type == JSONTokenType::BEGIN_ARRAY;
+        const bool closesContainer = token.type == JSONTokenType::END_OBJECT || token.type == JSONTokenType::END_ARRAY;
+
+        if (skipDepth > 0) {
+            skipDepth += opensContainer ? 1 : 0;
+            skipDepth -= closesContainer ? 1 : 0;
+            return;
+        }
+
+        if (token.type == JSONTokenType::KEY) {
+            Frame& frame = path.back();
+            frame.key.assign(token.text.data(), token.text.size());
+            frame.name = frame.key.find('\\') == std::string::npos ? frame.key : internal::unescapeString__internal(frame.key);
+            return;
+        }
+        else if (closesContainer) {
+            path.pop_back();
+
+            if (token.type == JSONTokenType::END_OBJECT) {
+                writer.endObject();
+            }
+            else {
+                writer.endArray();
+            }
+            return;
+        }
+
+        // every remaining token starts a value
+        if (!path.empty()) {
+            ++path.back().childCount;
+        }
+
+        const Rule* rule = path.size() <= maxRuleDepth ? matchCurrentValue() : nullptr;
+
+        if (rule && rule->action == FilterAction::DROP) {
+            skipDepth = opensContainer ? 1 : 0;
+            return;
+        }
+
+        if (!path.empty() && !path.back().isArray) {
+            writer.rawKey(path.back().key);
+        }
+
+        if (rule) {
+            writer.value(rule->replacement);
+            skipDepth = opensContainer ? 1 : 0;
+            return;
+        }
+
+        switch (token.type) {
+            case JSONTokenType::BEGIN_OBJECT:
+                writer.startObject();
+                path.push_back(Frame{false, 0, std::string(), std::string()});
+                break;
+            case JSONTokenType::BEGIN_ARRAY:
+                writer.startArray();
+                path.push_back(Frame{true, 0, std::string(), std::string()});
+                break;
+            case JSONTokenType::STRING:
+                writer.rawString(token.text);
+                break;
+            default:
+                writer.rawValue(token.text);
+                break;
+        }
+
+        return;
+    }
+
+    SIMPLEJSON_INLINE const JSONFilter::Rule* JSONFilter::matchCurrentValue() const {
+        for (const Rule& rule : rules) {
+            if (rule.tokens.size() != path.size()) {
+                continue;
+            }
+
+            bool matches = true;
+
+            for (size_t i = 0; matches && i < path.size(); ++i) {
+                const std::string& ruleToken = rule.tokens[i];
+
+                if (ruleToken == "*") {
+                    continue;
+                }
+                else if (path[i].isArray) {
+                    size_t index = 0;
+                    auto [end, error] = std::from_chars(ruleToken.data(), ruleToken.data() + ruleToken.size(), index);
+                    matches = error == std::errc() && end == ruleToken.data() + ruleToken.size() && index == path[i].childCount - 1;
+                }
+                else {
+                    matches = ruleToken == path[i].name;
+                }
+            }
+
+            if (matches) {
+                return &rule;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // SharedDocument
+
+    SIMPLEJSON_INLINE SharedDocument::SharedDocument() : document(freeze(JSONObject())) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE SharedDocument::SharedDocument(JSONObject obj) : document(freeze(std::move(obj))) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE std::shared_ptr<const JSONObject> SharedDocument::load() const {
+        return std::atomic_load(&document);
+    }
+
+    SIMPLEJSON_INLINE void SharedDocument::store(JSONObject obj) {
+        std::atomic_store(&document, freeze(std::move(obj)));
+        return;
+    }
+
+    SIMPLEJSON_INLINE void SharedDocument::reloadFromFile(const char* fileName) {
+        FUNCTRACE
+
+        std::ifstream stream(fileName);
+
+        if (!stream.is_open()) {
+            throw JSONException("Could not open file for reloading");
+        }
+
+        std::atomic_store(&document, freeze(internal::beginParseFromStream__internal(stream)));
+        return;
+    }
+
+    // JSONPointer
+
+    SIMPLEJSON_INLINE JSONPointer::JSONPointer() : tokens() { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONPointer::JSONPointer(const char* pointer) : JSONPointer(std::string(pointer)) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE JSONPointer::JSONPointer(const std::string& pointer) : tokens() {
+        FUNCTRACE
+
+        if (pointer.empty()) {
+            return;
+        }
+
+        if (pointer[0] != '/') {
+            std::string errorMessage = "Invalid JSON pointer \"" + pointer + "\", must be empty or start with '/'";
+            throw JSONException(errorMessage.c_str());
+        }
+
+        std::string token;
+
+        for (size_t i = 1; i <= pointer.size(); ++i) {
+            if (i == pointer.size() || pointer[i] == '/') {
+                tokens.push_back(token);
+                token.clear();
+            }
+            else if (pointer[i] == '~') {
+                if (i + 1 < pointer.size() && (pointer[i + 1] == '0' || pointer[i + 1] == '1')) {
+                    token += pointer[i + 1] == '0' ? '~' : '/';
+                    ++i;
+                }
+                else {
+                    std::string errorMessage = "Invalid JSON pointer \"" + pointer + "\", '~' must be followed by '0' or '1'";
+                    throw JSONException(errorMessage.c_str());
+                }
+            }
+            else {
+                token += pointer[i];
+            }
+        }
+    }
+
+    SIMPLEJSON_INLINE bool operator==(const JSONPointer& lhs, const JSONPointer& rhs) {
+        return lhs.tokens == rhs.tokens;
+    }
+
+    SIMPLEJSON_INLINE bool operator!=(const JSONPointer& lhs, const JSONPointer& rhs) {
+        return !(lhs == rhs);
+    }
+
+    SIMPLEJSON_INLINE const JSONObject* JSONPointer::resolve(const JSONObject& obj) const {
+        return resolveInto(obj, nullptr);
+    }
+
+    SIMPLEJSON_INLINE const JSONObject* JSONPointer::resolve(const JSONObject& obj, JSONObject& scratch) const {
+        return resolveInto(obj, &scratch);
+    }
+
+    SIMPLEJSON_INLINE const JSONObject* JSONPointer::resolveInto(const JSONObject& obj, JSONObject* scratch) const {
+        const JSONObject* current = &obj;
+
+        for (auto& token : tokens) {
+            if (current->isMap()) {
+                auto& map = current->asMap();
+                auto it = map.find(JSONString(token));
+
+                if (it == map.end()) {
+                    return nullptr;
+                }
+
+                current = &it->second;
+            }
+            else if (current->isArray()) {
+                auto& arr = current->asArray();
+
+                bool isIndex = !token.empty() && (token == "0" || token[0] != '0') && std::all_of(token.begin(), token.end(), [](char c) { return c >= '0' && c <= '9'; });
+
+                if (!isIndex || token.size() > 19 || std::stoull(token) >= arr.size()) {
+                    return nullptr;
+                }
+
+                if (arr.isPacked() && scratch) {
+                    *scratch = arr.get(size_t(std::stoull(token)));
+                    current = scratch;
+                }
+                else {
+                    current = &arr[size_t(std::stoull(token))];
+                }
+            }
+            else {
+                return nullptr;
+            }
+        }
+
+        return current;
+    }
+
+    SIMPLEJSON_INLINE const std::vector<std::string>& JSONPointer::getTokens() const {
+        return tokens;
+    }
+
+    SIMPLEJSON_INLINE JSONPointer JSONPointer::child(const std::string& token) const {
+        JSONPointer result = *this;
+        result.tokens.push_back(token);
+        return result;
+    }
+
+    SIMPLEJSON_INLINE std::string JSONPointer::toString() const {
+        std::string result;
+
+        for (auto& token : tokens) {
+            result += '/';
+
+            for (char c : token) {
+                if (c == '~') {
+                    result += "~0";
+                }
+                else if (c == '/') {
+                    result += "~1";
+                }
+                else {
+                    result += c;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    // StaticJSONView
+
+    SIMPLEJSON_INLINE JSONNumber StaticJSONView::getNumber() const {
+        if (!isNumber()) {
+            throw JSONException("This static JSON value is not a number");
+        }
+
+        if (nodes[nodeIndex].isFloating) {
+            std::string number(text.substr(nodes[nodeIndex].begin, nodes[nodeIndex].end - nodes[nodeIndex].begin));
+            return JSONNumber(internal::strToJSONFloating__internal(number));
+        }
+        else {
+            return JSONNumber(getIntegral());
+        }
+    }
+
+    SIMPLEJSON_INLINE JSONObject StaticJSONView::toJSONObject() const {
+        if (isString()) {
+            return JSONObject(std::string(getString()));
+        }
+        else if (isNumber()) {
+            return JSONObject(getNumber());
+        }
+        else if (isBool()) {
+            return JSONObject(getBoolean());
+        }
+        else if (isNull()) {
+            return JSONObject(JSONNull{});
+        }
+        else if (isArray()) {
+            JSONArray result;
+            size_t child = nodeIndex + 1;
+
+            for (size_t i = 0; i < size(); ++i) {
+                result.append(StaticJSONView(nodes, text, child).toJSONObject());
+                child = nodes[child].subtreeEnd;
+            }
+
+            return JSONObject(result);
+        }
+        else {
+            JSONObject result;
+            size_t keyNode = nodeIndex + 1;
+
+            for (size_t i = 0; i < getNumberOfFields(); ++i) {
+                result[std::string(StaticJSONView(nodes, text, keyNode).getString())] = StaticJSONView(nodes, text, keyNode + 1).toJSONObject();
+                keyNode = nodes[keyNode + 1].subtreeEnd;
+            }
+
+            return result;
+        }
+    }
+
+    // StaticJSON
+
+    namespace literals {
+        SIMPLEJSON_INLINE JSONObject operator""_json(const char* text, size_t length) {
+            return parseFromString(std::string(text, length));
+        }
+    }   // namespace literals
+
+    // JSONSnapshotView
+
+    SIMPLEJSON_INLINE JSONSnapshotView::JSONSnapshotView(const char* data, const size_t dataSize, const uint64_t nodeOffset)
+        : data(data), dataSize(dataSize), nodeOffset(nodeOffset) 
+    { 
+        FUNCTRACE 
+
+        if (nodeOffset > dataSize || dataSize - nodeOffset < internal::snapshotNodeHeaderSize) {
+            throw JSONException("Snapshot node offset out of range");
+        }
+    }
+
+    SIMPLEJSON_INLINE uint32_t JSONSnapshotView::tag() const {
+        return read<uint32_t>(nodeOffset);
+    }
+
+    SIMPLEJSON_INLINE uint32_t JSONSnapshotView::count() const {
+        return read<uint32_t>(nodeOffset + sizeof(uint32_t));
+    }
+
+    SIMPLEJSON_INLINE bool JSONSnapshotView::isString() const {
+        return tag() == uint32_t(internal::SnapshotTag::SNAPSHOT_STRING);
+    }
+
+    SIMPLEJSON_INLINE bool JSONSnapshotView::isNumber() const {
+        return tag() == uint32_t(internal::SnapshotTag::SNAPSHOT_INTEGRAL) || tag() == uint32_t(internal::SnapshotTag::SNAPSHOT_FLOATING);
+    }
+
+    SIMPLEJSON_INLINE bool JSONSnapshotView::isBool() const {
+        return tag() == uint32_t(internal::SnapshotTag::SNAPSHOT_BOOL);
+    }
+
+    SIMPLEJSON_INLINE bool JSONSnapshotView::isNull() const {
+        return tag() == uint32_t(internal::SnapshotTag::SNAPSHOT_NULL);
+    }
+
+    SIMPLEJSON_INLINE bool JSONSnapshotView::isArray() const {
+        return tag() == uint32_t(internal::SnapshotTag::SNAPSHOT_ARRAY);
+    }
+
+    SIMPLEJSON_INLINE bool JSONSnapshotView::isMap() const {
+        return tag() == uint32_t(internal::SnapshotTag::SNAPSHOT_MAP);
+    }
+
+    SIMPLEJSON_INLINE std::string_view JSONSnapshotView::getString() const {
+        if (!isString()) {
+            throw JSONException("This snapshot value is not a string");
+        }
+
+        uint64_t begin = nodeOffset + internal::snapshotNodeHeaderSize;
+        uint32_t length = count();
+
+        if (dataSize - begin < length) {
+            throw JSONException("Snapshot string out of range");
+        }
+
+        return std::string_view(data + begin, length);
+    }
+
+    SIMPLEJSON_INLINE JSONNumber JSONSnapshotView::getNumber() const {
+        uint64_t payload = nodeOffset + internal::snapshotNodeHeaderSize;
+
+        if (tag() == uint32_t(internal::SnapshotTag::SNAPSHOT_INTEGRAL)) {
+            return JSONNumber(read<JSONIntegral>(payload));
+        }
+        else if (tag() == uint32_t(internal::SnapshotTag::SNAPSHOT_FLOATING)) {
+            return JSONNumber(read<JSONFloating>(payload));
+        }
+        else {
+            throw JSONException("This snapshot value is not a number");
+        }
+    }
+
+    SIMPLEJSON_INLINE bool JSONSnapshotView::getBoolean() const {
+        if (!isBool()) {
+            throw JSONException("This snapshot value is not a bool");
+        }
+
+        return count() != 0;
+    }
+
+    SIMPLEJSON_INLINE size_t JSONSnapshotView::size() const {
+        if (!isArray()) {
+            throw JSONException("This snapshot value is not an array, cannot call size()");
+        }
+
+        return count();
+    }
+
+    SIMPLEJSON_INLINE JSONSnapshotView JSONSnapshotView::operator[](const size_t index) const {
+        if (index >= size()) {
+            throw JSONException("JSONSnapshotView operator[] index out of range");
+        }
+
+        uint64_t elementOffset = read<uint64_t>(nodeOffset + internal::snapshotNodeHeaderSize + index * sizeof(uint64_t));
+        return JSONSnapshotView(data, dataSize, elementOffset);
+    }
+
+    SIMPLEJSON_INLINE size_t JSONSnapshotView::getNumberOfFields() const {
+        if (!isMap()) {
+            throw JSONException("This snapshot value is not a map");
+        }
+
+        return count();
+    }
+
+    SIMPLEJSON_INLINE bool JSONSnapshotView::hasField(std::string_view key) const {
+        // fields are sorted by key, so a lookup is a binary search over the field table
+        size_t low = 0;
+        size_t high = getNumberOfFields();
+
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            int cmp = getKey(mid).compare(key);
+
+            if (cmp == 0) {
+                return true;
+            }
+            else if (cmp < 0) {
+                low = mid + 1;
+            }
+            else {
+                high = mid;
+            }
+        }
+
+        return false;
+    }
+
+    SIMPLEJSON_INLINE JSONSnapshotView JSONSnapshotView::operator[](std::string_view key) const {
+        size_t low = 0;
+        size_t high = getNumberOfFields();
+
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            int cmp = getKey(mid).compare(key);
+
+            if (cmp == 0) {
+                return getValue(mid);
+            }
+            else if (cmp < 0) {
+                low = mid + 1;
+            }
+            else {
+                high = mid;
+            }
+        }
+
+        std::string errorMessage = "Snapshot map does not contain key \"" + std::string(key) + "\"";
+        throw JSONException(errorMessage.c_str());
+    }
+
+    SIMPLEJSON_INLINE std::string_view JSONSnapshotView::getKey(const size_t fieldIndex) const {
+        if (fieldIndex >= getNumberOfFields()) {
+            throw JSONException("JSONSnapshotView field index out of range");
+        }
+
+        uint64_t keyOffset = read<uint64_t>(nodeOffset + internal::snapshotNodeHeaderSize + fieldIndex * 2 * sizeof(uint64_t));
+        return JSONSnapshotView(data, dataSize, keyOffset).getString();
+    }
+
+    SIMPLEJSON_INLINE JSONSnapshotView JSONSnapshotView::getValue(const size_t fieldIndex) const {
+        if (fieldIndex >= getNumberOfFields()) {
+            throw JSONException("JSONSnapshotView field index out of range");
+        }
+
+        uint64_t valueOffset = read<uint64_t>(nodeOffset + internal::snapshotNodeHeaderSize + (fieldIndex * 2 + 1) * sizeof(uint64_t));
+        return JSONSnapshotView(data, dataSize, valueOffset);
+    }
+
+    SIMPLEJSON_INLINE JSONObject JSONSnapshotView::toJSONObject() const {
+        switch (internal::SnapshotTag(tag())) {
+            case internal::SnapshotTag::SNAPSHOT_STRING:
+                return JSONObject(std::string(getString()));
+            case internal::SnapshotTag::SNAPSHOT_INTEGRAL: [[fallthrough]];
+            case internal::SnapshotTag::SNAPSHOT_FLOATING:
+                return JSONObject(getNumber());
+            case internal::SnapshotTag::SNAPSHOT_BOOL:
+                return JSONObject(getBoolean());
+            case internal::SnapshotTag::SNAPSHOT_NULL:
+                return JSONObject(JSONNull{});
+            case internal::SnapshotTag::SNAPSHOT_ARRAY: {
+                JSONArray result;
+
+                for (size_t i = 0; i < size(); ++i) {
+                    result.append((*this)[i].toJSONObject());
+                }
+
+                return JSONObject(result);
+            }
+            case internal::SnapshotTag::SNAPSHOT_MAP: {
+                JSONObject result;
+
+                for (size_t i = 0; i < getNumberOfFields(); ++i) {
+                    result[std::string(getKey(i))] = getValue(i).toJSONObject();
+                }
+
+                return result;
+            }
+            default:
+                throw JSONException("Unknown snapshot node tag");
+        }
+    }
+
+    // JSONSnapshot
+
+    SIMPLEJSON_INLINE JSONSnapshot::JSONSnapshot(const char* fileName) : ownedBytes(), data(nullptr), dataSize(0), isMapped(false) {
+        FUNCTRACE
+
+#ifdef SIMPLEJSON_HAS_MMAP
+        int fd = ::open(fileName, O_RDONLY);
+        
+        if (fd < 0) {
+            throw JSONException("Error while opening snapshot file");
+        }
+
+        struct stat fileInfo;
+        if (::fstat(fd, &fileInfo) != 0) {
+            ::close(fd);
+            throw JSONException("Error while reading snapshot file size");
+        }
+
+        dataSize = size_t(fileInfo.st_size);
+
+        if (dataSize > 0) {
+            void* mapping = ::mmap(nullptr, dataSize, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+
+            if (mapping == MAP_FAILED) {
+                throw JSONException("Error while memory mapping snapshot file");
+            }
+
+            data = static_cast<const char*>(mapping);
+            isMapped = true;
+        }
+        else {
+            ::close(fd);
+        }
+#else
+        std::ifstream stream(fileName, std::ios::binary);
+        
+        if (!stream) {
+            throw JSONException("Error while opening snapshot file");
+        }
+
+        ownedBytes.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        data = ownedBytes.data();
+        dataSize = ownedBytes.size();
+#endif
+
+        try {
+            validate();
+        }
+        catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    SIMPLEJSON_INLINE JSONSnapshot::JSONSnapshot(std::string snapshotBytes) : ownedBytes(std::move(snapshotBytes)), data(nullptr), dataSize(0), isMapped(false) { 
+        FUNCTRACE
+
+        data = ownedBytes.data();
+        dataSize = ownedBytes.size();
+        validate();
+    }
+
+    SIMPLEJSON_INLINE JSONSnapshot::JSONSnapshot(JSONSnapshot&& other) noexcept : ownedBytes(), data(nullptr), dataSize(0), isMapped(false) {
+        *this = std::move(other);
+    }
+
+    SIMPLEJSON_INLINE JSONSnapshot& JSONSnapshot::operator=(JSONSnapshot&& other) noexcept {
+        if (this != &other) {
+            release();
+
+            isMapped = other.isMapped;
+            dataSize = other.dataSize;
+
+            if (isMapped) {
+                data = other.data;
+            }
+            else {
+                ownedBytes = std::move(other.ownedBytes);
+                data = ownedBytes.data();
+            }
+
+            other.data = nullptr;
+            other.dataSize = 0;
+            other.isMapped = false;
+        }
+
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE JSONSnapshot::~JSONSnapshot() {
+        release();
+    }
+
+    SIMPLEJSON_INLINE JSONSnapshotView JSONSnapshot::root() const {
+        uint64_t rootOffset;
+        std::memcpy(&rootOffset, data + sizeof(internal::snapshotMagic), sizeof(rootOffset));
+        return JSONSnapshotView(data, dataSize, rootOffset);
+    }
+
+    SIMPLEJSON_INLINE void JSONSnapshot::validate() const {
+        if (dataSize < internal::snapshotHeaderSize || std::memcmp(data, internal::snapshotMagic, sizeof(internal::snapshotMagic)) != 0) {
+            throw JSONException("Invalid snapshot, bad header");
+        }
+
+        uint64_t rootOffset;
+        std::memcpy(&rootOffset, data + sizeof(internal::snapshotMagic), sizeof(rootOffset));
+
+        if (rootOffset < internal::snapshotHeaderSize || rootOffset > dataSize - internal::snapshotNodeHeaderSize) {
+            throw JSONException("Invalid snapshot, root offset out of range");
+        }
+    }
+
+    SIMPLEJSON_INLINE void JSONSnapshot::release() {
+#ifdef SIMPLEJSON_HAS_MMAP
+        if (isMapped) {
+            ::munmap(const_cast<char*>(data), dataSize);
+        }
+#endif
+        ownedBytes.clear();
+        data = nullptr;
+        dataSize = 0;
+        isMapped = false;
+        return;
+    }
+
+    // BinaryWriter
+
+    SIMPLEJSON_INLINE BinaryWriter::BinaryWriter() : buffer() { FUNCTRACE }
+
+    SIMPLEJSON_INLINE void BinaryWriter::writeByte(const uint8_t byte) {
+        buffer.push_back(char(byte));
+        return;
+    }
+
+    SIMPLEJSON_INLINE void BinaryWriter::writeBytes(const char* bytes, const size_t count) {
+        buffer.append(bytes, count);
+        return;
+    }
+
+    SIMPLEJSON_INLINE size_t BinaryWriter::position() const {
+        return buffer.size();
+    }
+
+    SIMPLEJSON_INLINE std::string BinaryWriter::release() {
+        return std::move(buffer);
+    }
+
+    // BinaryReader
+
+    SIMPLEJSON_INLINE BinaryReader::BinaryReader(std::string_view bytes) : bytes(bytes), pos(0) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE void BinaryReader::require(const size_t count) const {
+        if (bytes.size() - pos < count) {
+            throw JSONException("Unexpected end of binary input");
+        }
+    }
+
+    SIMPLEJSON_INLINE uint8_t BinaryReader::readByte() {
+        require(1);
+        return uint8_t(bytes[pos++]);
+    }
+
+    SIMPLEJSON_INLINE uint8_t BinaryReader::peekByte() const {
+        require(1);
+        return uint8_t(bytes[pos]);
+    }
+
+    SIMPLEJSON_INLINE std::string_view BinaryReader::readBytes(const size_t count) {
+        require(count);
+        std::string_view result = bytes.substr(pos, count);
+        pos += count;
+        return result;
+    }
+
+    SIMPLEJSON_INLINE size_t BinaryReader::position() const {
+        return pos;
+    }
+
+    SIMPLEJSON_INLINE size_t BinaryReader::remaining() const {
+        return bytes.size() - pos;
+    }
+
+    SIMPLEJSON_INLINE bool BinaryReader::atEnd() const {
+        return pos == bytes.size();
+    }
+
+    // BSONCodec
+
+    SIMPLEJSON_INLINE void BSONCodec::encode(BinaryWriter& writer, const JSONObject& obj) {
+        FUNCTRACE
+
+        if (!obj.isMap()) {
+            throw JSONException("Only JSONObjects holding a map can be encoded as a BSON document");
+        }
+
+        internal::encodeBSONDocument__internal(writer, obj);
+        return;
+    }
+
+    SIMPLEJSON_INLINE JSONObject BSONCodec::decode(BinaryReader& reader) {
+        FUNCTRACE
+        return internal::decodeBSONDocument__internal(reader, false, 0);
+    }
+
+    // UBJSONCodec
+
+    SIMPLEJSON_INLINE void UBJSONCodec::encode(BinaryWriter& writer, const JSONObject& obj) {
+        FUNCTRACE
+        internal::encodeUBJSONValue__internal(writer, obj);
+        return;
+    }
+
+    SIMPLEJSON_INLINE JSONObject UBJSONCodec::decode(BinaryReader& reader) {
+        FUNCTRACE
+
+        char marker = char(reader.readByte());
+
+        while (marker == 'N') {
+            marker = char(reader.readByte());
+        }
+
+        return internal::decodeUBJSONValue__internal(reader, marker, 0);
+    }
+
+} // namespace simpleJSON 
+
+namespace internal {
+    SIMPLEJSON_INLINE simpleJSON::JSONObject beginParseFromStream__internal(std::istream& stream) {
+        FUNCTRACE
+
+        simpleJSON::JSONObject result;
+        
+        char next = peekNextNonSpaceCharacter__internal(stream);
+
+        internal::NextJsonType nextType = internal::detectNextType__internal(next);
+
+        switch (nextType) {
+            case internal::NextJsonType::JSON_STRING:
+                result = internal::parseString__internal(stream);
+                break;
+            case internal::NextJsonType::JSON_NUMBER:
+                result = internal::parseNumber__internal(stream);
+                break;
+            case internal::NextJsonType::JSON_BOOL:
+                result = internal::parseBool__internal(stream);
+                break;
+            case internal::NextJsonType::JSON_NULL:
+                result = internal::parseNull__internal(stream);
+                break;
+            case internal::NextJsonType::JSON_ARRAY:
+                result = internal::parseArray__internal(stream);
+                break;
+            case internal::NextJsonType::JSON_OBJECT:
+                result = internal::parseObject__internal(stream);
+                break;
+            case internal::NextJsonType::JSON_END_OF_STREAM:    
+                // next read will fail and function will end
+                break;
+            default: 
+                std::string errorMessage = "Error while parsing object, unexpected next character '" + std::string{next} + "'";
+                throw simpleJSON::JSONException(errorMessage.c_str());
+                break;
+        }
+   
+        next = peekNextNonSpaceCharacter__internal(stream);
+
+        if (next != std::istream::traits_type::eof()) {
+            std::string errorMessage = "Error after reading a valid json object. Expected EOF but found '" + std::string{next} + "'"; 
+            throw simpleJSON::JSONException(errorMessage.c_str());
+        }
+        
+        return result;
+    }
+
+    SIMPLEJSON_INLINE NextJsonType detectNextType__internal(char nextCharInStream) {
+        switch (nextCharInStream) {
+            case '"':
+                return NextJsonType::JSON_STRING;
+            case '-': [[fallthrough]];
+            case '0': [[fallthrough]];
+            case '1': [[fallthrough]];
+            case '2': [[fallthrough]];
+            case '3': [[fallthrough]];
+            case '4': [[fallthrough]];
+            case '5': [[fallthrough]];
+            case '6': [[fallthrough]];
+            case '7': [[fallthrough]];
+            case '8': [[fallthrough]];
+            case '9':
+                return NextJsonType::JSON_NUMBER;
+            case 't': [[fallthrough]];
+            case 'f':
+                return NextJsonType::JSON_BOOL;
+            case 'n':
+                return NextJsonType::JSON_NULL;
+            case '[':
+                return NextJsonType::JSON_ARRAY;
+            case '{':
+                return NextJsonType::JSON_OBJECT;
+            case std::istream::traits_type::eof():
+                return NextJsonType::JSON_END_OF_STREAM;
+            default:
+                return NextJsonType::JSON_ERROR;
+        }
+    }
+
+    SIMPLEJSON_INLINE char peekNextNonSpaceCharacter__internal(std::istream& stream) {
+        char next = stream.peek();
+        
+        while (isspace(next)) {
+            stream.get();
+            next = stream.peek();
+        }
+
+        return next;
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONFloating strToJSONFloating__internal(const std::string& str) {
+        char* afterEnd;
+        simpleJSON::JSONFloating result;
+
+        if constexpr (std::is_same_v<simpleJSON::JSONFloating, float>) {
+            result = std::strtof(str.c_str(), &afterEnd);
+        }
+        else if constexpr (std::is_same_v<simpleJSON::JSONFloating, double>) {
+            result = std::strtod(str.c_str(), &afterEnd);
+        }
+        else {
+            result = std::strtold(str.c_str(), &afterEnd);
+        }
+
+        if (*afterEnd != '\0') {
+            std::string errorMessage = "Error while parsing number, invalid floating point number";
+            throw simpleJSON::JSONException(errorMessage.c_str());
+        }
+
+        return result;
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONIntegral strToJSONIntegral__internal(const std::string& str) {
+        char* afterEnd;
+        long long int parsed = std::strtoll(str.c_str(), &afterEnd, 10);
+
+        if (*afterEnd != '\0') {
+            std::string errorMessage = "Error while parsing number, invalid signed integer";
+            throw simpleJSON::JSONException(errorMessage.c_str());
+        }
+
+        // only reachable when JSONIntegral is narrower than long long
+        if (parsed < static_cast<long long int>(std::numeric_limits<simpleJSON::JSONIntegral>::min()) 
+            || parsed > static_cast<long long int>(std::numeric_limits<simpleJSON::JSONIntegral>::max())) {
+            std::string errorMessage = "Error while parsing number, signed integer out of range";
+            throw simpleJSON::JSONException(errorMessage.c_str());
+        }
+
+        return static_cast<simpleJSON::JSONIntegral>(parsed);
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONString parseString__internal(std::istream& stream) {
+        FUNCTRACE
+
+        char currentChar;
+        stream.get(currentChar);
+
+        if (currentChar != '"') {
+            std::string errorMessage = "Error while parsing string, expected '\"'";
+            throw simpleJSON::JSONException(errorMessage.c_str());
+        }
+
+        std::string result;
+        bool currentCharIsEscaped = false;
+
+        while (stream) {
+            stream.get(currentChar);
+
+            if (currentChar == '"' && !currentCharIsEscaped) {
+                return result;
+            }
+            
+            if (currentChar == '\\' && !currentCharIsEscaped) {
+                currentCharIsEscaped = true;
+            }
+            else if (currentCharIsEscaped) {
+                currentCharIsEscaped = false;
+            }
+            
+            result += currentChar;
+        }
+
+        // should not get here
+        std::string errorMessage = "Error while parsing string, unexpected end of stream";
+        throw simpleJSON::JSONException(errorMessage.c_str());
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONNumber parseNumber__internal(std::istream& stream) {
+        FUNCTRACE
+
+        char c = stream.peek();
+        std::string numberAsString;
+
+        short dotCount = 0;
+        short eCount = 0;
+
+        while (isdigit(c) || c == '.' || c == '-' || c == 'e' || c == 'E' || c == '+') {
+            if (c == '.') {
+                ++dotCount;
+            }
+            else if (c == 'e' || c == 'E') {
+                ++eCount;
+            }
+
+            stream.get(c);
+            numberAsString += c;
+
+            c = stream.peek();
+        }
+        
+        if (dotCount != 0 || eCount != 0) {
+            return simpleJSON::JSONNumber{internal::strToJSONFloating__internal(numberAsString)};
+        }
+        else {
+            return simpleJSON::JSONNumber{internal::strToJSONIntegral__internal(numberAsString)};
+        }
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONBool parseBool__internal(std::istream& stream) {
+        FUNCTRACE
+
+        char c1, c2, c3, c4;
+        stream.get(c1);
+        stream.get(c2);
+        stream.get(c3);
+        stream.get(c4);
+
+        std::string out = {c1, c2, c3, c4};
+
+        if (out == "true") {
+            return simpleJSON::JSONBool(true);
+        }
+        else if (out[0] == 'f') {
+            char c5;
             stream.get(c5);
 
-            out += c5;
+            out += c5;
+
+            if (out == "false") {
+                return simpleJSON::JSONBool(false);
+            } 
+        }
+
+        std::string errorMessage = "Error while parsing bool, expected \"true\" or \"false\", got \"" + out + "\"";
+        throw simpleJSON::JSONException(errorMessage.c_str());
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONNull parseNull__internal(std::istream& stream) {
+        FUNCTRACE
+
+        char c1, c2, c3, c4;
+        stream.get(c1);
+        stream.get(c2);
+        stream.get(c3);
+        stream.get(c4);
+
+        std::string out = {c1, c2, c3, c4};
+
+        if (out != "null") {
+            std::string errorMessage = "Error while parsing null, expected \"null\", got \"" + out + "\"";
+            throw simpleJSON::JSONException(errorMessage.c_str());
+        }
+
+        return simpleJSON::JSONNull{};
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONArray parseArray__internal(std::istream& stream) {
+        FUNCTRACE
+
+        char c;
+        stream.get(c);
+
+        if (c != '[') {
+            std::string errorMessage = "Error while parsing array, expected '[', got '" + std::string{c} + "'";
+            throw simpleJSON::JSONException(errorMessage.c_str());
+        }
+
+        simpleJSON::JSONArray result;
+
+        bool expectingComma = false;
+        bool lastReadWasComma = false;
+
+        while (stream) {
+            c = peekNextNonSpaceCharacter__internal(stream);
+
+            if (c == ',') {
+                if (expectingComma) {
+                    stream.get(c);
+                    expectingComma = false;
+                    lastReadWasComma = true;
+                    continue;
+                }
+                else {
+                    throw simpleJSON::JSONException("Unexpected comma when parsing array");
+                }
+            }
+
+            if (c == ']') {
+                if (lastReadWasComma) {
+                    throw simpleJSON::JSONException("Trailing comma not allowed in array");
+                }
+                else {
+                    stream.get(c);
+                    return result;
+                }
+            }
+
+            NextJsonType nextType = detectNextType__internal(c);
+            
+            switch (nextType) {
+                case NextJsonType::JSON_STRING: 
+                    result.append(parseString__internal(stream));
+                    break;
+                case NextJsonType::JSON_NUMBER:
+                    result.append(parseNumber__internal(stream));
+                    break;
+                case NextJsonType::JSON_BOOL:
+                    result.append(parseBool__internal(stream));
+                    break;
+                case NextJsonType::JSON_NULL:
+                    result.append(parseNull__internal(stream));
+                    break;
+                case NextJsonType::JSON_ARRAY:
+                    result.append(parseArray__internal(stream));
+                    break;
+                case NextJsonType::JSON_OBJECT:
+                    result.append(parseObject__internal(stream));
+                    break;
+                case NextJsonType::JSON_END_OF_STREAM:
+                    // next read will fail and function will end
+                    break;
+                default: 
+                    std::string errorMessage = "Error while parsing array, unexpected next character '" + std::string{c} + "'"; 
+                    throw simpleJSON::JSONException(errorMessage.c_str());
+                    break;
+            }
+
+            expectingComma = true;
+            lastReadWasComma = false;
+        }
+
+        // should not get here
+        std::string errorMessage = "Error while parsing array, unexpected end of stream";
+        throw simpleJSON::JSONException(errorMessage.c_str());
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONObject parseObject__internal(std::istream& stream) {
+        FUNCTRACE
+
+        char next;
+        stream.get(next);
+
+        if (next != '{') {
+            std::string errorMessage = "Error while parsing object, expected '{', got '" + std::string{next} + "'";
+            throw simpleJSON::JSONException(errorMessage.c_str());
+        }
+
+        simpleJSON::JSONObject result;
+
+        bool lastReadWasComma = false;
+
+        while (stream) {
+            next = peekNextNonSpaceCharacter__internal(stream);
+
+            if (next == '}') {
+                if (lastReadWasComma) {
+                    throw simpleJSON::JSONException("Trailing comma not allowed in object");
+                }
+                stream.get();
+                return result;
+            }
+
+            lastReadWasComma = false;
+
+            // must read string as map key if object is not empty
+            if (next != '"') {
+                std::string errorMessage = "Error while parsing object, expected '\"', got '" + std::string{next} + "'";
+                throw simpleJSON::JSONException(errorMessage.c_str());
+            }
+
+            simpleJSON::JSONString key = parseString__internal(stream);
+
+            // possible white space between map key and :
+            next = peekNextNonSpaceCharacter__internal(stream);
+            stream.get(next);
+
+            // must read separator
+            if (next != ':') {
+                std::string errorMessage = "Error while parsing object, expected ':', got '" + std::string{next} + "'";
+                throw simpleJSON::JSONException(errorMessage.c_str());
+            }
+
+            // possible white space between : and map value
+            next = peekNextNonSpaceCharacter__internal(stream);
+
+            NextJsonType nextType = detectNextType__internal(next);
+            
+            switch (nextType) {
+                case NextJsonType::JSON_STRING:
+                    result[key] = parseString__internal(stream);
+                    break;
+                case NextJsonType::JSON_NUMBER:
+                    result[key] = parseNumber__internal(stream);
+                    break;
+                case NextJsonType::JSON_BOOL:
+                    result[key] = parseBool__internal(stream);
+                    break;
+                case NextJsonType::JSON_NULL:
+                    result[key] = parseNull__internal(stream);
+                    break;
+                case NextJsonType::JSON_ARRAY:
+                    result[key] = parseArray__internal(stream);
+                    break;
+                case NextJsonType::JSON_OBJECT:
+                    result[key] = parseObject__internal(stream);
+                    break;
+                case NextJsonType::JSON_END_OF_STREAM:
+                    // next read will fail and function will end
+                    break;
+                default: 
+                    std::string errorMessage = "Error while parsing object, unexpected next character '" + std::string{next} + "'"; 
+                    throw simpleJSON::JSONException(errorMessage.c_str());
+                    break;
+            }
+
+            //  possible white space between map value and , or }
+            next = peekNextNonSpaceCharacter__internal(stream);
+            stream.get(next);
+            
+            if (next == ',') {
+                lastReadWasComma = true;
+                continue;
+            }
+            else if (next == '}') {
+                break;
+            }
+            else {
+                std::string errorMessage = "Error while parsing object, unexpected next character '" + std::string{next} + "'"; 
+                throw simpleJSON::JSONException(errorMessage.c_str());
+            }
+        }
+        
+        return result;
+    }
+
+    SIMPLEJSON_INLINE uint64_t beginSnapshotNode__internal(std::string& out, const SnapshotTag tag, const uint32_t count) {
+        // nodes are kept 8 byte aligned so that a mapped snapshot can be read with natural loads
+        out.append((8 - out.size() % 8) % 8, '\0');
+
+        uint64_t nodeOffset = out.size();
+        appendSnapshotValue__internal(out, uint32_t(tag));
+        appendSnapshotValue__internal(out, count);
+
+        return nodeOffset;
+    }
+
+    SIMPLEJSON_INLINE uint64_t writeSnapshotString__internal(std::string& out, const std::string& str) {
+        if (str.size() > UINT32_MAX) {
+            throw simpleJSON::JSONException("String is too long to be stored in a snapshot");
+        }
+
+        uint64_t nodeOffset = beginSnapshotNode__internal(out, SnapshotTag::SNAPSHOT_STRING, uint32_t(str.size()));
+        out += str;
+
+        return nodeOffset;
+    }
+
+    SIMPLEJSON_INLINE uint64_t writeSnapshotNode__internal(std::string& out, const simpleJSON::JSONObject& obj) {
+        // children are written before their parent so the parent can store their final offsets
+        if (obj.isString()) {
+            return writeSnapshotString__internal(out, obj.asString().getString());
+        }
+        else if (obj.isNumber()) {
+            auto& num = obj.asNumber();
+
+            if (num.isIntegral()) {
+                uint64_t nodeOffset = beginSnapshotNode__internal(out, SnapshotTag::SNAPSHOT_INTEGRAL, 0);
+                appendSnapshotValue__internal(out, num.getIntegral());
+                return nodeOffset;
+            }
+            else {
+                uint64_t nodeOffset = beginSnapshotNode__internal(out, SnapshotTag::SNAPSHOT_FLOATING, 0);
+                appendSnapshotValue__internal(out, num.getFloating());
+                return nodeOffset;
+            }
+        }
+        else if (obj.isBool()) {
+            return beginSnapshotNode__internal(out, SnapshotTag::SNAPSHOT_BOOL, obj.asBool().getBoolean() ? 1 : 0);
+        }
+        else if (obj.isNull()) {
+            return beginSnapshotNode__internal(out, SnapshotTag::SNAPSHOT_NULL, 0);
+        }
+        else if (obj.isArray()) {
+            auto& arr = obj.asArray();
+
+            // counts are stored as 32 bit values
+            if (arr.size() > UINT32_MAX) {
+                throw simpleJSON::JSONException("Array has too many elements to be stored in a snapshot");
+            }
+
+            std::vector<uint64_t> elementOffsets;
+            elementOffsets.reserve(arr.size());
+
+            arr.forEach([&](const simpleJSON::JSONObject& elem) {
+                elementOffsets.push_back(writeSnapshotNode__internal(out, elem));
+            });
+
+            uint64_t nodeOffset = beginSnapshotNode__internal(out, SnapshotTag::SNAPSHOT_ARRAY, uint32_t(elementOffsets.size()));
+
+            for (auto elementOffset : elementOffsets) {
+                appendSnapshotValue__internal(out, elementOffset);
+            }
+
+            return nodeOffset;
+        }
+        else if (obj.isMap()) {
+            auto& map = obj.asMap();
+
+            if (map.size() > UINT32_MAX) {
+                throw simpleJSON::JSONException("Object has too many fields to be stored in a snapshot");
+            }
+
+            std::vector<std::pair<std::string, std::pair<uint64_t, uint64_t>>> fields;
+            fields.reserve(map.size());
+
+            for (auto& [key, val] : map) {
+                std::string keyString = key.getString();
+                uint64_t keyOffset = writeSnapshotString__internal(out, keyString);
+                uint64_t valueOffset = writeSnapshotNode__internal(out, val);
+                fields.push_back({std::move(keyString), {keyOffset, valueOffset}});
+            }
+
+            // readers binary search the field table by raw key bytes
+            std::sort(fields.begin(), fields.end(), [](auto& lhs, auto& rhs) { return lhs.first < rhs.first; });
+
+            uint64_t nodeOffset = beginSnapshotNode__internal(out, SnapshotTag::SNAPSHOT_MAP, uint32_t(fields.size()));
+
+            for (auto& field : fields) {
+                appendSnapshotValue__internal(out, field.second.first);
+                appendSnapshotValue__internal(out, field.second.second);
+            }
+
+            return nodeOffset;
+        }
+        
+        // should not get here
+        throw simpleJSON::JSONException("Error when writing JSONObject to snapshot");
+    }
+
+    SIMPLEJSON_INLINE std::string unescapeString__internal(const std::string& str) {
+        std::string result;
+        result.reserve(str.size());
+
+        auto readHex4 = [&](size_t pos) {
+            if (pos + 4 > str.size()) {
+                throw simpleJSON::JSONException("Error while unescaping string, incomplete \\u escape sequence");
+            }
+
+            uint32_t codeUnit = 0;
+
+            for (size_t i = pos; i < pos + 4; ++i) {
+                char c = str[i];
+                codeUnit <<= 4;
+
+                if (c >= '0' && c <= '9') {
+                    codeUnit |= uint32_t(c - '0');
+                }
+                else if (c >= 'a' && c <= 'f') {
+                    codeUnit |= uint32_t(c - 'a' + 10);
+                }
+                else if (c >= 'A' && c <= 'F') {
+                    codeUnit |= uint32_t(c - 'A' + 10);
+                }
+                else {
+                    throw simpleJSON::JSONException("Error while unescaping string, invalid hex digit in \\u escape sequence");
+                }
+            }
+
+            return codeUnit;
+        };
+
+        for (size_t i = 0; i < str.size(); ++i) {
+            if (str[i] != '\\') {
+                result += str[i];
+                continue;
+            }
+
+            if (++i == str.size()) {
+                throw simpleJSON::JSONException("Error while unescaping string, unterminated escape sequence");
+            }
+
+            switch (str[i]) {
+                case '"':   result += '"'; break;
+                case '\\':  result += '\\'; break;
+                case '/':   result += '/'; break;
+                case 'b':   result += '\b'; break;
+                case 'f':   result += '\f'; break;
+                case 'n':   result += '\n'; break;
+                case 'r':   result += '\r'; break;
+                case 't':   result += '\t'; break;
+                case 'u': {
+                    uint32_t codePoint = readHex4(i + 1);
+                    i += 4;
+
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                        if (i + 2 >= str.size() || str[i + 1] != '\\' || str[i + 2] != 'u') {
+                            throw simpleJSON::JSONException("Error while unescaping string, unpaired high surrogate");
+                        }
+
+                        uint32_t low = readHex4(i + 3);
+
+                        if (low < 0xDC00 || low > 0xDFFF) {
+                            throw simpleJSON::JSONException("Error while unescaping string, invalid low surrogate");
+                        }
+
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    }
+                    else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                        throw simpleJSON::JSONException("Error while unescaping string, unpaired low surrogate");
+                    }
+
+                    appendUTF8__internal(result, codePoint);
+                    break;
+                }
+                default:
+                    std::string errorMessage = "Error while unescaping string, invalid escape sequence '\\" + std::string{str[i]} + "'";
+                    throw simpleJSON::JSONException(errorMessage.c_str());
+            }
+        }
+
+        return result;
+    }
+
+    SIMPLEJSON_INLINE std::string escapeString__internal(std::string_view str) {
+        static const char* hexDigits = "0123456789abcdef";
+
+        std::string result;
+        result.reserve(str.size());
+
+        for (char c : str) {
+            switch (c) {
+                case '"':   result += "\\\""; break;
+                case '\\':  result += "\\\\"; break;
+                case '\b':  result += "\\b"; break;
+                case '\f':  result += "\\f"; break;
+                case '\n':  result += "\\n"; break;
+                case '\r':  result += "\\r"; break;
+                case '\t':  result += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        result += "\\u00";
+                        result += hexDigits[static_cast<unsigned char>(c) >> 4];
+                        result += hexDigits[static_cast<unsigned char>(c) & 0xF];
+                    }
+                    else {
+                        result += c;
+                    }
+                    break;
+            }
+        }
+
+        return result;
+    }
+
+    SIMPLEJSON_INLINE void appendUTF8__internal(std::string& out, const uint32_t codePoint) {
+        if (codePoint < 0x80) {
+            out += char(codePoint);
+        }
+        else if (codePoint < 0x800) {
+            out += char(0xC0 | (codePoint >> 6));
+            out += char(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000) {
+            out += char(0xE0 | (codePoint >> 12));
+            out += char(0x80 | ((codePoint >> 6) & 0x3F));
+            out += char(0x80 | (codePoint & 0x3F));
+        }
+        else {
+            out += char(0xF0 | (codePoint >> 18));
+            out += char(0x80 | ((codePoint >> 12) & 0x3F));
+            out += char(0x80 | ((codePoint >> 6) & 0x3F));
+            out += char(0x80 | (codePoint & 0x3F));
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE void libraryCompiledWithSameTraits__internal(const simpleJSON::JSONTraits*) {
+        return;
+    }
+
+    // NumberSum__internal
+
+    SIMPLEJSON_INLINE void NumberSum__internal::addIntegral(const int64_t val) {
+        constexpr uint64_t lowMask = 0xFFFFFFFF;
+
+        // the upper half of a negative value read as unsigned is 2^32 too large
+        uint64_t bits = uint64_t(val);
+        upper += int64_t(bits >> 32) - int64_t((bits >> 63) << 32);
+        lower += bits & lowMask;
+        upper += int64_t(lower >> 32);
+        lower &= lowMask;
+        return;
+    }
+
+    SIMPLEJSON_INLINE void NumberSum__internal::addIntegrals(const simpleJSON::JSONIntegral* data, const size_t count) {
+        using simpleJSON::JSONIntegral;
+
+        if constexpr (sizeof(JSONIntegral) < sizeof(int64_t)) {
+            // cannot overflow for fewer than 2^32 elements
+            int64_t total = 0;
+
+            for (size_t i = 0; i < count; ++i) {
+                total += data[i];
+            }
+
+            addIntegral(total);
+        }
+        else {
+            // Every element is split into its upper and lower 32 bits, which are summed separately and cannot overflow
+            // within a block.
+            constexpr size_t blockSize = size_t(1) << 30;
+            constexpr uint64_t lowMask = 0xFFFFFFFF;
+
+            for (size_t blockStart = 0; blockStart < count; blockStart += blockSize) {
+                size_t blockEnd = std::min(count, blockStart + blockSize);
+                size_t i = blockStart;
+                uint64_t blockUpper = 0;
+                uint64_t blockLower = 0;
+                uint64_t negatives = 0;
+
+#ifdef __AVX2__
+                __m256i upperLanes = _mm256_setzero_si256();
+                __m256i lowerLanes = _mm256_setzero_si256();
+                __m256i negativeLanes = _mm256_setzero_si256();
+                const __m256i lowMaskLanes = _mm256_set1_epi64x(int64_t(lowMask));
+                const __m256i zero = _mm256_setzero_si256();
+
+                for (; i + 4 <= blockEnd; i += 4) {
+                    __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    upperLanes = _mm256_add_epi64(upperLanes, _mm256_srli_epi64(next, 32));
+                    lowerLanes = _mm256_add_epi64(lowerLanes, _mm256_and_si256(next, lowMaskLanes));
+                    // the comparison yields -1 for negative elements
+                    negativeLanes = _mm256_sub_epi64(negativeLanes, _mm256_cmpgt_epi64(zero, next));
+                }
+
+                alignas(32) uint64_t lanes[3][4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0]), upperLanes);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1]), lowerLanes);
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[2]), negativeLanes);
+                blockUpper = lanes[0][0] + lanes[0][1] + lanes[0][2] + lanes[0][3];
+                blockLower = lanes[1][0] + lanes[1][1] + lanes[1][2] + lanes[1][3];
+                negatives = lanes[2][0] + lanes[2][1] + lanes[2][2] + lanes[2][3];
+#endif
+
+                for (; i < blockEnd; ++i) {
+                    uint64_t bits = uint64_t(data[i]);
+                    blockUpper += bits >> 32;
+                    blockLower += bits & lowMask;
+                    negatives += bits >> 63;
+                }
+
+                // the upper halves were summed as unsigned numbers, each negative element added 2^32 too much
+                upper += int64_t(blockUpper) - int64_t(negatives << 32) + int64_t(blockLower >> 32);
+                lower += blockLower & lowMask;
+                upper += int64_t(lower >> 32);
+                lower &= lowMask;
+            }
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE void NumberSum__internal::addFloatings(const simpleJSON::JSONFloating* data, const size_t count) {
+        // independent accumulators break the dependency chain between consecutive additions, local copies keep
+        // them in registers
+        simpleJSON::JSONFloating acc[4] = {floatings[0], floatings[1], floatings[2], floatings[3]};
+        size_t i = 0;
+
+        for (; i < count && (floatingCount + i) % 4 != 0; ++i) {
+            acc[(floatingCount + i) % 4] += data[i];
+        }
+
+        for (; i + 4 <= count; i += 4) {
+            acc[0] += data[i];
+            acc[1] += data[i + 1];
+            acc[2] += data[i + 2];
+            acc[3] += data[i + 3];
+        }
+
+        for (; i < count; ++i) {
+            acc[(floatingCount + i) % 4] += data[i];
+        }
+
+        std::copy(acc, acc + 4, floatings);
+        floatingCount += count;
+        return;
+    }
+
+    SIMPLEJSON_INLINE void NumberSum__internal::add(const simpleJSON::JSONNumber& num) {
+        if (num.isIntegral()) {
+            addIntegral(int64_t(num.getIntegral()));
+        }
+        else {
+            floatings[floatingCount % 4] += num.getFloating();
+            ++floatingCount;
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONNumber NumberSum__internal::result() const {
+        using simpleJSON::JSONIntegral;
+        using simpleJSON::JSONFloating;
+
+        if (floatingCount == 0 && upper >= std::numeric_limits<int32_t>::min() && upper <= std::numeric_limits<int32_t>::max()) {
+            int64_t total = int64_t((uint64_t(upper) << 32) | lower);
+
+            if (total >= int64_t(std::numeric_limits<JSONIntegral>::min()) && total <= int64_t(std::numeric_limits<JSONIntegral>::max())) {
+                return simpleJSON::JSONNumber(JSONIntegral(total));
+            }
+        }
+
+        JSONFloating integralTotal = JSONFloating(upper) * JSONFloating(4294967296.0) + JSONFloating(lower);
+
+        if (floatingCount == 0) {
+            return simpleJSON::JSONNumber(integralTotal);
+        }
+
+        JSONFloating floatingTotal = (floatings[0] + floatings[1]) + (floatings[2] + floatings[3]);
+        return simpleJSON::JSONNumber(upper == 0 && lower == 0 ? floatingTotal : integralTotal + floatingTotal);
+    }
+
+    SIMPLEJSON_INLINE const simpleJSON::JSONNumber& numberElement__internal(const simpleJSON::JSONObject& elem) {
+        if (!elem.isNumber()) {
+            throw simpleJSON::JSONException("JSONArray aggregation failed, array contains an element that is not a number");
+        }
+
+        return elem.asNumber();
+    }
+
+    SIMPLEJSON_INLINE void unpackArrays__internal(simpleJSON::JSONObject& obj) {
+        if (obj.isArray()) {
+            auto& arr = obj.asArray();
+
+            // non-const element access unpacks the array
+            for (size_t i = 0; i < arr.size(); ++i) {
+                unpackArrays__internal(arr[i]);
+            }
+        }
+        else if (obj.isMap()) {
+            for (auto& [key, val] : obj.asMap()) {
+                unpackArrays__internal(val);
+            }
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE void collectChildren__internal(const simpleJSON::JSONObject& obj, ChildList__internal& children, std::vector<simpleJSON::JSONObject>& storage) {
+        if (obj.isArray()) {
+            const auto& arr = obj.asArray();
+            children.reserve(arr.size());
+
+            if (arr.isPacked()) {
+                // reserved up front so that the collected pointers stay valid
+                storage.reserve(arr.size());
+                arr.forEach([&](const simpleJSON::JSONObject& elem) { storage.push_back(elem); });
+
+                for (auto& elem : storage) {
+                    children.emplace_back(nullptr, &elem);
+                }
+            }
+            else {
+                arr.forEach([&](const simpleJSON::JSONObject& elem) { children.emplace_back(nullptr, &elem); });
+            }
+        }
+        else if (obj.isMap()) {
+            children.reserve(obj.getNumberOfFields());
+
+            for (auto& [key, val] : obj.asMap()) {
+                children.emplace_back(&key, &val);
+            }
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE bool isLargeContainer__internal(const simpleJSON::JSONObject& obj) {
+        return (obj.isArray() && obj.asArray().size() >= parallelMinChildren__internal) || (obj.isMap() && obj.getNumberOfFields() >= parallelMinChildren__internal);
+    }
+
+    SIMPLEJSON_INLINE std::vector<ChildRange__internal> splitChildren__internal(const std::vector<char>& isLarge) {
+        constexpr size_t maxChunks = 256;
+
+        const size_t chunkSize = std::max(size_t(1), (isLarge.size() + maxChunks - 1) / maxChunks);
+        std::vector<ChildRange__internal> ranges;
+        size_t begin = 0;
+
+        for (size_t i = 0; i < isLarge.size(); ++i) {
+            if (isLarge[i]) {
+                if (begin < i) {
+                    ranges.push_back({begin, i, false});
+                }
+                ranges.push_back({i, i + 1, true});
+                begin = i + 1;
+            }
+            else if (i + 1 - begin == chunkSize) {
+                ranges.push_back({begin, i + 1, false});
+                begin = i + 1;
+            }
+        }
+
+        if (begin < isLarge.size()) {
+            ranges.push_back({begin, isLarge.size(), false});
+        }
+
+        return ranges;
+    }
+
+    SIMPLEJSON_INLINE bool equalsParallel__internal(const simpleJSON::JSONObject& lhs, const simpleJSON::JSONObject& rhs, const size_t threadCount, std::atomic<bool>& mismatch) {
+        if (mismatch) {
+            return false;
+        }
+
+        bool bothArrays = lhs.isArray() && rhs.isArray();
+        bool bothMaps = lhs.isMap() && rhs.isMap();
+
+        if ((!bothArrays && !bothMaps) || (bothArrays && lhs.asArray().isPacked() && rhs.asArray().isPacked())) {
+            return lhs == rhs;
+        }
+
+        size_t count = bothArrays ? lhs.size() : lhs.getNumberOfFields();
+
+        if (count != (bothArrays ? rhs.size() : rhs.getNumberOfFields())) {
+            return false;
+        }
+
+        ChildList__internal lhsChildren, rhsChildren;
+        std::vector<simpleJSON::JSONObject> lhsStorage, rhsStorage;
+        collectChildren__internal(lhs, lhsChildren, lhsStorage);
+        collectChildren__internal(rhs, rhsChildren, rhsStorage);
+
+        auto keysEqual = [&](const size_t i) {
+            return bothArrays || *lhsChildren[i].first == *rhsChildren[i].first;
+        };
+
+        if (count < parallelMinChildren__internal) {
+            for (size_t i = 0; i < count; ++i) {
+                if (!keysEqual(i) || !equalsParallel__internal(*lhsChildren[i].second, *rhsChildren[i].second, threadCount, mismatch)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::vector<char> isLarge(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            isLarge[i] = isLargeContainer__internal(*lhsChildren[i].second);
+        }
+
+        // the recursion checks the shared flag at every level, so a mismatch anywhere stops all workers early
+        std::vector<ChildRange__internal> ranges = splitChildren__internal(isLarge);
+
+        auto compareRange = [&](const ChildRange__internal& range, const size_t childThreadCount) {
+            for (size_t i = range.begin; i < range.end && !mismatch; ++i) {
+                if (!keysEqual(i) || !equalsParallel__internal(*lhsChildren[i].second, *rhsChildren[i].second, childThreadCount, mismatch)) {
+                    mismatch = true;
+                }
+            }
+        };
+
+        parallelFor__internal(ranges.size(), threadCount, [&](const size_t r) {
+            if (!ranges[r].isLarge) {
+                compareRange(ranges[r], 1);
+            }
+        });
+
+        for (auto& range : ranges) {
+            if (range.isLarge) {
+                compareRange(range, threadCount);
+            }
+        }
+
+        return !mismatch;
+    }
+
+    SIMPLEJSON_INLINE uint64_t combineHash__internal(const uint64_t seed, const uint64_t value) {
+        return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+
+    SIMPLEJSON_INLINE uint64_t hashParallel__internal(const simpleJSON::JSONObject& obj, const size_t threadCount) {
+        if (obj.isString()) {
+            return combineHash__internal(1, hashKey__internal(obj.asString().getStringView()));
+        }
+        else if (obj.isNumber()) {
+            const auto& num = obj.asNumber();
+
+            if (num.isIntegral()) {
+                return combineHash__internal(2, std::hash<simpleJSON::JSONIntegral>{}(num.getIntegral()));
+            }
+            else {
+                return combineHash__internal(3, std::hash<simpleJSON::JSONFloating>{}(num.getFloating()));
+            }
+        }
+        else if (obj.isBool()) {
+            return combineHash__internal(4, obj.asBool().getBoolean() ? 1 : 0);
+        }
+        else if (obj.isNull()) {
+            return combineHash__internal(5, 0);
+        }
+
+        ChildList__internal children;
+        std::vector<simpleJSON::JSONObject> storage;
+        collectChildren__internal(obj, children, storage);
+
+        // child hashes are always combined in order, so the result does not depend on how the work was split
+        std::vector<uint64_t> childHashes(children.size());
+
+        auto hashChild = [&](const size_t i, const size_t childThreadCount) {
+            uint64_t valueHash = hashParallel__internal(*children[i].second, childThreadCount);
+            childHashes[i] = children[i].first ? combineHash__internal(hashKey__internal(children[i].first->getStringView()), valueHash) : valueHash;
+        };
+
+        if (children.size() < parallelMinChildren__internal) {
+            for (size_t i = 0; i < children.size(); ++i) {
+                hashChild(i, threadCount);
+            }
+        }
+        else {
+            std::vector<char> isLarge(children.size());
+
+            for (size_t i = 0; i < children.size(); ++i) {
+                isLarge[i] = isLargeContainer__internal(*children[i].second);
+            }
+
+            std::vector<ChildRange__internal> ranges = splitChildren__internal(isLarge);
+
+            parallelFor__internal(ranges.size(), threadCount, [&](const size_t r) {
+                for (size_t i = ranges[r].begin; i < ranges[r].end && !ranges[r].isLarge; ++i) {
+                    hashChild(i, 1);
+                }
+            });
+
+            for (auto& range : ranges) {
+                if (range.isLarge) {
+                    hashChild(range.begin, threadCount);
+                }
+            }
+        }
+
+        uint64_t result = combineHash__internal(obj.isArray() ? 6 : 7, children.size());
+
+        for (uint64_t childHash : childHashes) {
+            result = combineHash__internal(result, childHash);
+        }
+
+        return result;
+    }
+
+    SIMPLEJSON_INLINE void diffParallel__internal(const simpleJSON::JSONObject& lhs, const simpleJSON::JSONObject& rhs, const simpleJSON::JSONPointer& path, 
+                                                  std::vector<simpleJSON::JSONDifference>& out, const size_t threadCount) {
+        bool bothArrays = lhs.isArray() && rhs.isArray();
+        bool bothMaps = lhs.isMap() && rhs.isMap();
+
+        if (!bothArrays && !bothMaps) {
+            if (lhs != rhs) {
+                out.push_back({simpleJSON::DifferenceKind::CHANGED, path});
+            }
+            return;
+        }
+
+        ChildList__internal lhsChildren, rhsChildren;
+        std::vector<simpleJSON::JSONObject> lhsStorage, rhsStorage;
+        collectChildren__internal(lhs, lhsChildren, lhsStorage);
+        collectChildren__internal(rhs, rhsChildren, rhsStorage);
+
+        // Children are matched first (by position or key), in document order. A pair with a missing side
+        // becomes an ADDED or REMOVED difference, the others are compared recursively.
+        struct ChildPair {
+            std::string token;
+            const simpleJSON::JSONObject* lhs;
+            const simpleJSON::JSONObject* rhs;
+        };
+
+        std::vector<ChildPair> pairs;
+
+        if (bothArrays) {
+            for (size_t i = 0; i < std::max(lhsChildren.size(), rhsChildren.size()); ++i) {
+                pairs.push_back({std::to_string(i), 
+                                 i < lhsChildren.size() ? lhsChildren[i].second : nullptr, 
+                                 i < rhsChildren.size() ? rhsChildren[i].second : nullptr});
+            }
+        }
+        else {
+            size_t l = 0, r = 0;
+
+            while (l < lhsChildren.size() || r < rhsChildren.size()) {
+                if (r == rhsChildren.size() || (l < lhsChildren.size() && *lhsChildren[l].first < *rhsChildren[r].first)) {
+                    pairs.push_back({lhsChildren[l].first->getString(), lhsChildren[l].second, nullptr});
+                    ++l;
+                }
+                else if (l == lhsChildren.size() || *rhsChildren[r].first < *lhsChildren[l].first) {
+                    pairs.push_back({rhsChildren[r].first->getString(), nullptr, rhsChildren[r].second});
+                    ++r;
+                }
+                else {
+                    pairs.push_back({lhsChildren[l].first->getString(), lhsChildren[l].second, rhsChildren[r].second});
+                    ++l;
+                    ++r;
+                }
+            }
+        }
+
+        auto diffPair = [&](const ChildPair& pair, std::vector<simpleJSON::JSONDifference>& target, const size_t childThreadCount) {
+            if (!pair.rhs) {
+                target.push_back({simpleJSON::DifferenceKind::REMOVED, path.child(pair.token)});
+            }
+            else if (!pair.lhs) {
+                target.push_back({simpleJSON::DifferenceKind::ADDED, path.child(pair.token)});
+            }
+            else {
+                diffParallel__internal(*pair.lhs, *pair.rhs, path.child(pair.token), target, childThreadCount);
+            }
+        };
+
+        if (pairs.size() < parallelMinChildren__internal) {
+            for (auto& pair : pairs) {
+                diffPair(pair, out, threadCount);
+            }
+            return;
+        }
+
+        std::vector<char> isLarge(pairs.size());
+
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            isLarge[i] = pairs[i].lhs && pairs[i].rhs && (isLargeContainer__internal(*pairs[i].lhs) || isLargeContainer__internal(*pairs[i].rhs));
+        }
+
+        // differences are collected per range and concatenated in range order, which keeps document order
+        std::vector<ChildRange__internal> ranges = splitChildren__internal(isLarge);
+        std::vector<std::vector<simpleJSON::JSONDifference>> chunks(ranges.size());
+
+        parallelFor__internal(ranges.size(), threadCount, [&](const size_t r) {
+            for (size_t i = ranges[r].begin; i < ranges[r].end && !ranges[r].isLarge; ++i) {
+                diffPair(pairs[i], chunks[r], 1);
+            }
+        });
+
+        for (size_t r = 0; r < ranges.size(); ++r) {
+            if (ranges[r].isLarge) {
+                diffPair(pairs[ranges[r].begin], chunks[r], threadCount);
+            }
+        }
+
+        for (auto& chunk : chunks) {
+            out.insert(out.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE void dumpParallel__internal(const simpleJSON::JSONObject& obj, std::string& out, std::string& currentIndentation, const std::string* indentString, const size_t threadCount) {
+        // containers with fewer children are not split, but their children are still searched for large containers
+        constexpr size_t minChildrenToSplit = 1024;
+        constexpr size_t maxChunks = 256;
+
+        const bool pretty = indentString != nullptr;
+
+        if (!obj.isArray() && !obj.isMap()) {
+            out += pretty ? obj.toIndentedString(currentIndentation, *indentString) : obj.toString();
+            return;
+        }
+
+        const bool isArray = obj.isArray();
+        const size_t count = isArray ? obj.asArray().size() : obj.getNumberOfFields();
+
+        if (count == 0) {
+            out += isArray ? "[]" : "{}";
+            return;
+        }
+
+        std::vector<std::pair<const simpleJSON::JSONString*, const simpleJSON::JSONObject*>> fields;
+
+        if (!isArray) {
+            fields.reserve(count);
+            for (auto& [key, val] : obj.asMap()) {
+                fields.emplace_back(&key, &val);
+            }
+        }
+
+        const std::string separator = pretty ? ",\n" : ",";
+        std::string childIndentation = pretty ? currentIndentation + *indentString : "";
+
+        auto appendPrefix = [&](std::string& target, const simpleJSON::JSONString* key) {
+            target += childIndentation;
+            if (key) {
+                target += key->toString() + (pretty ? " : " : ":");
+            }
+        };
+
+        out += isArray ? "[" : "{";
+        out += pretty ? "\n" : "";
+
+        if (count < minChildrenToSplit) {
+            for (size_t i = 0; i < count; ++i) {
+                out += i > 0 ? separator : "";
+
+                if (isArray) {
+                    appendPrefix(out, nullptr);
+                    obj.asArray().forEachInRange(i, i + 1, [&](const simpleJSON::JSONObject& elem) {
+                        dumpParallel__internal(elem, out, childIndentation, indentString, threadCount);
+                    });
+                }
+                else {
+                    appendPrefix(out, fields[i].first);
+                    dumpParallel__internal(*fields[i].second, out, childIndentation, indentString, threadCount);
+                }
+            }
+        }
+        else {
+            const size_t chunkCount = std::min(maxChunks, count / (minChildrenToSplit / 4));
+            std::vector<std::string> chunks(chunkCount);
+
+            parallelFor__internal(chunkCount, threadCount, [&](const size_t chunk) {
+                const size_t begin = count * chunk / chunkCount;
+                const size_t end = count * (chunk + 1) / chunkCount;
+
+                std::string& target = chunks[chunk];
+                std::string indentation = childIndentation;
+
+                auto appendValue = [&](const simpleJSON::JSONObject& val) {
+                    target += pretty ? val.toIndentedString(indentation, *indentString) : val.toString();
+                };
+
+                if (isArray) {
+                    size_t i = begin;
+                    obj.asArray().forEachInRange(begin, end, [&](const simpleJSON::JSONObject& elem) {
+                        target += i++ > begin ? separator : "";
+                        appendPrefix(target, nullptr);
+                        appendValue(elem);
+                    });
+                }
+                else {
+                    for (size_t i = begin; i < end; ++i) {
+                        target += i > begin ? separator : "";
+                        appendPrefix(target, fields[i].first);
+                        appendValue(*fields[i].second);
+                    }
+                }
+            });
+
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+                out += chunk > 0 ? separator : "";
+                out += chunks[chunk];
+            }
+        }
+
+        if (pretty) {
+            out += "\n" + currentIndentation;
+        }
+        out += isArray ? "]" : "}";
+        return;
+    }
+
+    // LengthCounter__internal
+
+    SIMPLEJSON_INLINE LengthCounter__internal& LengthCounter__internal::operator+=(const char) {
+        ++length;
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE LengthCounter__internal& LengthCounter__internal::operator+=(std::string_view text) {
+        length += text.size();
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE void LengthCounter__internal::append(const char*, const size_t count) {
+        length += count;
+        return;
+    }
+
+    SIMPLEJSON_INLINE size_t formatNumber__internal(const simpleJSON::JSONNumber& num, char* buffer, const size_t bufferSize) {
+        // same formatting as std::to_string, which JSONNumber::toString uses
+        if (num.isIntegral()) {
+            return size_t(std::to_chars(buffer, buffer + bufferSize, num.getIntegral()).ptr - buffer);
+        }
+        else {
+            return size_t(std::snprintf(buffer, bufferSize, "%Lf", static_cast<long double>(num.getFloating())));
+        }
+    }
+
+    SIMPLEJSON_INLINE void appendNumber__internal(std::string& out, const simpleJSON::JSONNumber& num) {
+        char buffer[64];
+        size_t length = formatNumber__internal(num, buffer, sizeof(buffer));
+
+        if (length < sizeof(buffer)) {
+            out.append(buffer, length);
+        }
+        else {
+            out += num.toString();
+        }
+
+        return;
+    }
+
+    SIMPLEJSON_INLINE void appendNumber__internal(LengthCounter__internal& out, const simpleJSON::JSONNumber& num) {
+        char buffer[64];
+        out.length += formatNumber__internal(num, buffer, sizeof(buffer));
+        return;
+    }
+
+    SIMPLEJSON_INLINE double canonicalDouble__internal(const simpleJSON::JSONNumber& num) {
+        // conversions to double round to nearest, ties to even, unless a program changes the rounding mode
+        if (num.isIntegral()) {
+            return static_cast<double>(num.getIntegral());
+        }
+        else {
+            return static_cast<double>(num.getFloating());
+        }
+    }
+
+    SIMPLEJSON_INLINE size_t formatCanonicalNumber__internal(const double value, char* buffer) {
+        if (value == 0) {
+            // covers -0 as well
+            buffer[0] = '0';
+            return 1;
+        }
+
+        char* out = buffer;
+
+        if (value < 0) {
+            *out++ = '-';
+        }
+
+        // shortest round trip digits, d.ddde[+-]x
+        char scientific[32];
+        char* end = std::to_chars(scientific, scientific + sizeof(scientific), std::fabs(value), std::chars_format::scientific).ptr;
+        char* exponentStart = std::find(scientific, end, 'e');
+
+        char digits[20];
+        size_t digitCount = 0;
+
+        for (char* c = scientific; c != exponentStart; ++c) {
+            if (*c != '.') {
+                digits[digitCount++] = *c;
+            }
+        }
+
+        int exponent = 0;
+        std::from_chars(exponentStart + (exponentStart[1] == '+' ? 2 : 1), end, exponent);
+
+        // value is 0.digits * 10^n
+        const int n = exponent + 1;
+        const int k = int(digitCount);
+
+        if (k <= n && n <= 21) {
+            out = std::copy(digits, digits + k, out);
+            out = std::fill_n(out, n - k, '0');
+        }
+        else if (0 < n && n <= 21) {
+            out = std::copy(digits, digits + n, out);
+            *out++ = '.';
+            out = std::copy(digits + n, digits + k, out);
+        }
+        else if (-6 < n && n <= 0) {
+            *out++ = '0';
+            *out++ = '.';
+            out = std::fill_n(out, -n, '0');
+            out = std::copy(digits, digits + k, out);
+        }
+        else {
+            *out++ = digits[0];
+
+            if (k > 1) {
+                *out++ = '.';
+                out = std::copy(digits + 1, digits + k, out);
+            }
+
+            *out++ = 'e';
+            *out++ = n - 1 > 0 ? '+' : '-';
+            out = std::to_chars(out, out + 4, std::abs(n - 1)).ptr;
+        }
+
+        return size_t(out - buffer);
+    }
+
+    SIMPLEJSON_INLINE std::string canonicalString__internal(const std::string& raw) {
+        return escapeString__internal(raw.find('\\') == std::string::npos ? raw : unescapeString__internal(raw));
+    }
+
+    SIMPLEJSON_INLINE bool utf16Less__internal(std::string_view lhs, std::string_view rhs) {
+        size_t i = 0;
+
+        while (i < lhs.size() && i < rhs.size() && lhs[i] == rhs[i]) {
+            ++i;
+        }
+
+        if (i == rhs.size()) {
+            return false;
+        }
+        else if (i == lhs.size()) {
+            return true;
+        }
+
+        // UTF-8 byte order is code point order. UTF-16 order only differs when U+E000..U+FFFF (lead bytes EE and EF)
+        // meets a supplementary code point (lead bytes F0 and up), which UTF-16 stores as surrogates D800..DFFF.
+        // Bytes after a common prefix are either both lead bytes or continuation bytes of the same lead byte.
+        const unsigned char left = static_cast<unsigned char>(lhs[i]);
+        const unsigned char right = static_cast<unsigned char>(rhs[i]);
+
+        if (left >= 0xF0 && (right == 0xEE || right == 0xEF)) {
+            return true;
+        }
+        else if (right >= 0xF0 && (left == 0xEE || left == 0xEF)) {
+            return false;
+        }
+        else {
+            return left < right;
+        }
+    }
+
+    // SHA256Sink__internal
+
+    SIMPLEJSON_INLINE SHA256Sink__internal& SHA256Sink__internal::operator+=(const char c) {
+        hash.update(std::string_view(&c, 1));
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE SHA256Sink__internal& SHA256Sink__internal::operator+=(std::string_view text) {
+        hash.update(text);
+        return *this;
+    }
+
+    SIMPLEJSON_INLINE size_t skipWhitespace__internal(std::string_view text, size_t pos) {
+#ifdef __SSE2__
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i carriageReturn = _mm_set1_epi8('\r');
+
+        for (; pos + 16 <= text.size(); pos += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+            __m128i isWhitespace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, tab)),
+                                                _mm_or_si128(_mm_cmpeq_epi8(bytes, newline), _mm_cmpeq_epi8(bytes, carriageReturn)));
+            unsigned mask = unsigned(_mm_movemask_epi8(isWhitespace)) ^ 0xFFFFu;
+
+            if (mask != 0) {
+                return pos + size_t(__builtin_ctz(mask));
+            }
+        }
+#endif
+
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+            ++pos;
+        }
+
+        return pos;
+    }
+
+    SIMPLEJSON_INLINE size_t findQuoteOrBackslash__internal(std::string_view text, size_t pos) {
+#ifdef __SSE2__
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+
+        for (; pos + 16 <= text.size(); pos += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+            unsigned mask = unsigned(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash))));
+
+            if (mask != 0) {
+                return pos + size_t(__builtin_ctz(mask));
+            }
+        }
+#endif
+
+        while (pos < text.size() && text[pos] != '"' && text[pos] != '\\') {
+            ++pos;
+        }
+
+        return pos;
+    }
+
+    SIMPLEJSON_INLINE std::string syntaxErrorMessage__internal(const simpleJSON::JSONSyntaxErrorKind kind, const size_t offset, const char* source) {
+        using Kind = simpleJSON::JSONSyntaxErrorKind;
+
+        const char* problem = "";
+
+        switch (kind) {
+            case Kind::UNEXPECTED_END_OF_INPUT:     problem = "unexpected end of input"; break;
+            case Kind::EXPECTED_END_OF_INPUT:       problem = "expected end of input after a valid value"; break;
+            case Kind::EXPECTED_KEY:                problem = "expected '\"' to start a key"; break;
+            case Kind::EXPECTED_COLON:              problem = "expected ':'"; break;
+            case Kind::EXPECTED_COMMA_OR_END:       problem = "expected ',' or the end of the container"; break;
+            case Kind::UNEXPECTED_CHARACTER:        problem = "unexpected character"; break;
+            case Kind::CONTROL_CHARACTER_IN_STRING: problem = "control character in string"; break;
+            case Kind::INVALID_UNICODE_ESCAPE:      problem = "invalid \\u escape sequence"; break;
+            case Kind::INVALID_ESCAPE:              problem = "invalid escape sequence"; break;
+            case Kind::UNTERMINATED_STRING:         problem = "unterminated string"; break;
+            case Kind::INVALID_NUMBER:              problem = "invalid number"; break;
+            case Kind::EXPECTED_FRACTION_DIGITS:    problem = "expected digits after '.'"; break;
+            case Kind::EXPECTED_EXPONENT_DIGITS:    problem = "expected digits in exponent"; break;
+            case Kind::INVALID_LITERAL:             problem = "invalid literal"; break;
+        }
+
+        return std::string("Error while parsing ") + source + ", " + problem + " (at byte " + std::to_string(offset) + ")";
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONSyntaxError StaticJSONParser__internal::syntaxError(const simpleJSON::JSONSyntaxErrorKind kind) const {
+        return simpleJSON::JSONSyntaxError(kind, pos, "static JSON");
+    }
+
+    SIMPLEJSON_INLINE size_t validateString__internal(std::string_view text, const size_t pos, const size_t textOffset) {
+        StaticJSONParser__internal validator{text, pos, nullptr, 0};
+
+        try {
+            validator.parseString();
+        }
+        catch (const simpleJSON::JSONSyntaxError& e) {
+            throw simpleJSON::JSONSyntaxError(e.getKind(), textOffset + e.getOffset());
+        }
+
+        return validator.pos;
+    }
+
+    SIMPLEJSON_INLINE size_t validateNumber__internal(std::string_view text, const size_t pos, const size_t textOffset) {
+        StaticJSONParser__internal validator{text, pos, nullptr, 0};
+
+        try {
+            validator.parseNumber();
+        }
+        catch (const simpleJSON::JSONSyntaxError& e) {
+            throw simpleJSON::JSONSyntaxError(e.getKind(), textOffset + e.getOffset());
+        }
+
+        if (validator.pos < text.size()) {
+            char next = text[validator.pos];
+
+            if ((next >= '0' && next <= '9') || next == '.' || next == '-' || next == '+' || next == 'e' || next == 'E') {
+                throw simpleJSON::JSONSyntaxError(simpleJSON::JSONSyntaxErrorKind::INVALID_NUMBER, textOffset + validator.pos);
+            }
+        }
+
+        return validator.pos;
+    }
+
+    SIMPLEJSON_INLINE void validateLiteral__internal(std::string_view literal, const size_t offset) {
+        if (literal != "true" && literal != "false" && literal != "null") {
+            throw simpleJSON::JSONSyntaxError(simpleJSON::JSONSyntaxErrorKind::INVALID_LITERAL, offset);
+        }
+        return;
+    }
+
+    // JSONSyntaxState__internal
+
+    SIMPLEJSON_INLINE void JSONSyntaxState__internal::reset() {
+        containers.clear();
+        expect = Expect::VALUE;
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONSyntaxState__internal::structural(const char c, const size_t offset) {
+        switch (c) {
+            case '{':
+            case '[':
+                beginValue(offset);
+                containers.push_back(c);
+                expect = c == '{' ? Expect::KEY_OR_END_OBJECT : Expect::VALUE_OR_END_ARRAY;
+                break;
+            case '}':
+            case ']': {
+                char open = c == '}' ? '{' : '[';
+                bool isEmpty = expect == (c == '}' ? Expect::KEY_OR_END_OBJECT : Expect::VALUE_OR_END_ARRAY);
+
+                if (!isEmpty && !(expect == Expect::COMMA_OR_END && containers.back() == open)) {
+                    unexpected(offset);
+                }
+
+                containers.pop_back();
+                afterValue();
+                break;
+            }
+            case ',':
+                if (expect != Expect::COMMA_OR_END) {
+                    unexpected(offset);
+                }
+                expect = containers.back() == '{' ? Expect::KEY : Expect::VALUE;
+                break;
+            default:
+                if (expect != Expect::COLON) {
+                    unexpected(offset);
+                }
+                expect = Expect::VALUE;
+                break;
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONSyntaxState__internal::beginString(const size_t offset) const {
+        if (expect != Expect::KEY && expect != Expect::KEY_OR_END_OBJECT) {
+            beginValue(offset);
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE bool JSONSyntaxState__internal::endString() {
+        if (expect == Expect::KEY || expect == Expect::KEY_OR_END_OBJECT) {
+            expect = Expect::COLON;
+            return true;
+        }
+
+        afterValue();
+        return false;
+    }
+
+    SIMPLEJSON_INLINE void JSONSyntaxState__internal::beginValue(const size_t offset) const {
+        if (expect != Expect::VALUE && expect != Expect::VALUE_OR_END_ARRAY) {
+            unexpected(offset);
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONSyntaxState__internal::afterValue() {
+        expect = containers.empty() ? Expect::NOTHING : Expect::COMMA_OR_END;
+        return;
+    }
+
+    SIMPLEJSON_INLINE void JSONSyntaxState__internal::finish(const size_t offset) const {
+        if (expect != Expect::NOTHING) {
+            throw simpleJSON::JSONSyntaxError(simpleJSON::JSONSyntaxErrorKind::UNEXPECTED_END_OF_INPUT, offset);
+        }
+        return;
+    }
+
+    SIMPLEJSON_INLINE bool JSONSyntaxState__internal::isComplete() const {
+        return expect == Expect::NOTHING;
+    }
+
+    SIMPLEJSON_INLINE void JSONSyntaxState__internal::unexpected(const size_t offset) const {
+        using Kind = simpleJSON::JSONSyntaxErrorKind;
+
+        switch (expect) {
+            case Expect::KEY:
+            case Expect::KEY_OR_END_OBJECT:     throw simpleJSON::JSONSyntaxError(Kind::EXPECTED_KEY, offset);
+            case Expect::COLON:                 throw simpleJSON::JSONSyntaxError(Kind::EXPECTED_COLON, offset);
+            case Expect::COMMA_OR_END:          throw simpleJSON::JSONSyntaxError(Kind::EXPECTED_COMMA_OR_END, offset);
+            case Expect::NOTHING:               throw simpleJSON::JSONSyntaxError(Kind::EXPECTED_END_OF_INPUT, offset);
+            default:                            throw simpleJSON::JSONSyntaxError(Kind::UNEXPECTED_CHARACTER, offset);
+        }
+    }
+
+    SIMPLEJSON_INLINE size_t findStringSpecial__internal(std::string_view text, size_t pos) {
+#ifdef __SSE2__
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i lastControl = _mm_set1_epi8(0x1F);
+
+        for (; pos + 16 <= text.size(); pos += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + pos));
+            // unsigned bytes <= 0x1F are the ones that max() leaves at 0x1F
+            __m128i isControl = _mm_cmpeq_epi8(_mm_max_epu8(bytes, lastControl), lastControl);
+            __m128i isSpecial = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash)), isControl);
+            unsigned mask = unsigned(_mm_movemask_epi8(isSpecial));
+
+            if (mask != 0) {
+                return pos + size_t(__builtin_ctz(mask));
+            }
+        }
+#endif
+
+        while (pos < text.size() && text[pos] != '"' && text[pos] != '\\' && static_cast<unsigned char>(text[pos]) >= 0x20) {
+            ++pos;
+        }
+
+        return pos;
+    }
+
+    SIMPLEJSON_INLINE void minifyDocument__internal(std::string_view json, std::string& out) {
+        FUNCTRACE
+
+        JSONSyntaxState__internal syntax;
+        size_t pos = 0;
+        size_t runStart = 0;
+
+        // the output is never longer than the input, runs are copied straight into it
+        size_t outStart = out.size();
+        out.resize(outStart + json.size());
+        char* written = out.data() + outStart;
+
+        while (pos < json.size()) {
+            char c = json[pos];
+
+            switch (c) {
+                case ' ':
+                case '\t':
+                case '\n':
+                case '\r':
+                    std::memcpy(written, json.data() + runStart, pos - runStart);
+                    written += pos - runStart;
+                    pos = skipWhitespace__internal(json, pos + 1);
+                    runStart = pos;
+                    break;
+                case '{':
+                case '[':
+                case '}':
+                case ']':
+                case ',':
+                case ':':
+                    syntax.structural(c, pos);
+                    ++pos;
+                    break;
+                case '"': {
+                    syntax.beginString(pos);
+
+                    size_t stringStart = pos;
+                    pos = findStringSpecial__internal(json, pos + 1);
+
+                    // escapes, control characters and a missing end go through the full string grammar
+                    if (pos == json.size() || json[pos] != '"') {
+                        pos = validateString__internal(json, stringStart, 0);
+                    }
+                    else {
+                        ++pos;
+                    }
+
+                    syntax.endString();
+                    break;
+                }
+                case 't':
+                case 'f':
+                case 'n': {
+                    syntax.beginValue(pos);
+
+                    size_t literalEnd = pos + 1;
+
+                    while (literalEnd < json.size() && json[literalEnd] >= 'a' && json[literalEnd] <= 'z') {
+                        ++literalEnd;
+                    }
+
+                    validateLiteral__internal(json.substr(pos, literalEnd - pos), pos);
+                    pos = literalEnd;
+                    syntax.afterValue();
+                    break;
+                }
+                default: {
+                    if (c != '-' && !(c >= '0' && c <= '9')) {
+                        syntax.unexpected(pos);
+                    }
+
+                    syntax.beginValue(pos);
+                    pos = validateNumber__internal(json, pos, 0);
+                    syntax.afterValue();
+                    break;
+                }
+            }
+        }
+
+        std::memcpy(written, json.data() + runStart, pos - runStart);
+        written += pos - runStart;
+        out.resize(size_t(written - out.data()));
+
+        syntax.finish(pos);
+        return;
+    }
+
+    SIMPLEJSON_INLINE void writeToken__internal(simpleJSON::JSONWriter& writer, const simpleJSON::JSONToken& token) {
+        switch (token.type) {
+            case simpleJSON::JSONTokenType::BEGIN_OBJECT:   writer.startObject(); break;
+            case simpleJSON::JSONTokenType::END_OBJECT:     writer.endObject(); break;
+            case simpleJSON::JSONTokenType::BEGIN_ARRAY:    writer.startArray(); break;
+            case simpleJSON::JSONTokenType::END_ARRAY:      writer.endArray(); break;
+            case simpleJSON::JSONTokenType::KEY:            writer.rawKey(token.text); break;
+            case simpleJSON::JSONTokenType::STRING:         writer.rawString(token.text); break;
+            default:                                        writer.rawValue(token.text); break;
+        }
+
+        return;
+    }
+
+    SIMPLEJSON_INLINE void reformat__internal(std::istream& in, simpleJSON::JSONWriter& writer) {
+        FUNCTRACE
+
+        constexpr size_t chunkSize = 1 << 16;
+
+        simpleJSON::JSONTokenizer tokenizer;
+        std::string chunk(chunkSize, '\0');
+        auto onToken = [&](const simpleJSON::JSONToken& token) { writeToken__internal(writer, token); };
+
+        while (in.read(chunk.data(), std::streamsize(chunkSize)) || in.gcount() > 0) {
+            tokenizer.feed(std::string_view(chunk.data(), size_t(in.gcount())), onToken);
+        }
+
+        tokenizer.finish(onToken);
+        writer.flush();
+        return;
+    }
+
+    SIMPLEJSON_INLINE void reformat__internal(std::string_view json, simpleJSON::JSONWriter& writer) {
+        FUNCTRACE
+
+        simpleJSON::JSONTokenizer tokenizer;
+        auto onToken = [&](const simpleJSON::JSONToken& token) { writeToken__internal(writer, token); };
+
+        tokenizer.feed(json, onToken);
+        tokenizer.finish(onToken);
+        return;
+    }
+
+    SIMPLEJSON_INLINE void readBlocks__internal(const char* fileName, const size_t blockSize, BoundedQueue__internal<std::string>& freeBlocks, 
+                                                BoundedQueue__internal<std::string>& filledBlocks, std::exception_ptr& error) {
+        try {
+#ifdef SIMPLEJSON_HAS_MMAP
+            int fd = ::open(fileName, O_RDONLY);
+
+            if (fd < 0) {
+                throw simpleJSON::JSONException("Could not open file for pipelined parsing");
+            }
+
+            off_t offset = 0;
+            std::string block;
+
+            while (freeBlocks.pop(block)) {
+                block.resize(blockSize);
+                ssize_t bytesRead = ::pread(fd, block.data(), blockSize, offset);
+
+                // a signal that arrives before anything was read interrupts the call, it is simply repeated
+                while (bytesRead < 0 && errno == EINTR) {
+                    bytesRead = ::pread(fd, block.data(), blockSize, offset);
+                }
+
+                if (bytesRead < 0) {
+                    ::close(fd);
+                    throw simpleJSON::JSONException("Error while reading file for pipelined parsing");
+                }
+                else if (bytesRead == 0) {
+                    break;
+                }
+
+                offset += bytesRead;
+                block.resize(size_t(bytesRead));
+
+                if (!filledBlocks.push(std::move(block))) {
+                    break;
+                }
+            }
+
+            ::close(fd);
+#else
+            std::ifstream stream(fileName, std::ios::binary);
+
+            if (!stream.is_open()) {
+                throw simpleJSON::JSONException("Could not open file for pipelined parsing");
+            }
+
+            std::string block;
+
+            while (freeBlocks.pop(block)) {
+                block.resize(blockSize);
+                stream.read(block.data(), std::streamsize(blockSize));
+
+                if (stream.gcount() == 0) {
+                    break;
+                }
+
+                block.resize(size_t(stream.gcount()));
+
+                if (!filledBlocks.push(std::move(block))) {
+                    break;
+                }
+            }
+#endif
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        filledBlocks.close();
+        return;
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONObject parsePipelined__internal(const char* fileName, const size_t blockSize, const size_t blockCount, simpleJSON::JSONStreamParser& parser) {
+        FUNCTRACE
+
+        BoundedQueue__internal<std::string> freeBlocks(blockCount);
+        BoundedQueue__internal<std::string> filledBlocks(blockCount);
+        std::exception_ptr readError;
+
+        for (size_t i = 0; i < std::max(size_t(1), blockCount); ++i) {
+            freeBlocks.push(std::string());
+        }
+
+        std::thread reader(readBlocks__internal, fileName, std::max(size_t(1), blockSize), std::ref(freeBlocks), std::ref(filledBlocks), std::ref(readError));
+
+        try {
+            std::string block;
+
+            while (filledBlocks.pop(block)) {
+                parser.feed(block);
+                freeBlocks.push(std::move(block));
+            }
+        }
+        catch (...) {
+            freeBlocks.close();
+            filledBlocks.close();
+            reader.join();
+            throw;
+        }
+
+        reader.join();
+
+        if (readError) {
+            std::rethrow_exception(readError);
+        }
+
+        return parser.finish();
+    }
+
+    // WorkerPool__internal
+
+    SIMPLEJSON_INLINE WorkerPool__internal& WorkerPool__internal::shared() {
+        static WorkerPool__internal pool;
+        return pool;
+    }
+
+    SIMPLEJSON_INLINE WorkerPool__internal::~WorkerPool__internal() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        jobAvailable.notify_all();
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    SIMPLEJSON_INLINE void WorkerPool__internal::run(const std::function<void()>& work, const size_t helperCount) {
+        Job job{&work, helperCount, 0};
+
+        if (helperCount > 0) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                // grows to the most helpers ever asked for at once
+                while (threads.size() < helperCount) {
+                    threads.emplace_back([this]() { workerLoop(); });
+                }
+
+                jobs.push_back(&job);
+            }
+            jobAvailable.notify_all();
+        }
+
+        work();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        auto queued = std::find(jobs.begin(), jobs.end(), &job);
+
+        if (queued != jobs.end()) {
+            jobs.erase(queued);
+        }
+
+        helpersDone.wait(lock, [&]() { return job.active == 0; });
+        return;
+    }
+
+    SIMPLEJSON_INLINE void WorkerPool__internal::workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true) {
+            jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+
+            if (stopping) {
+                return;
+            }
+
+            Job* job = jobs.front();
+            ++job->active;
+
+            if (--job->wanted == 0) {
+                jobs.pop_front();
+            }
+
+            lock.unlock();
+            (*job->work)();
+            lock.lock();
+
+            if (--job->active == 0) {
+                helpersDone.notify_all();
+            }
+        }
+    }
+
+    SIMPLEJSON_INLINE void parseBatchDocument__internal(MemoryStreamBuffer__internal& buffer, std::istream& stream, std::string_view document, simpleJSON::BatchParseResult& result) {
+        buffer.reset(document);
+        stream.clear();
+
+        try {
+            result.value = beginParseFromStream__internal(stream);
+            result.success = true;
+        }
+        catch (const std::exception& e) {
+            result.error = e.what();
+        }
+
+        return;
+    }
+
+    SIMPLEJSON_INLINE bool readWholeFile__internal(const char* fileName, std::string& content, std::string& error) {
+#ifdef SIMPLEJSON_HAS_MMAP
+        int fd = ::open(fileName, O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0) {
+            error = "Could not open file";
+            return false;
+        }
+
+        struct stat fileStat;
+        content.clear();
+
+        if (::fstat(fd, &fileStat) == 0 && fileStat.st_size > 0) {
+            content.resize(size_t(fileStat.st_size));
+        }
+
+        size_t bytesRead = 0;
+
+        while (true) {
+            if (bytesRead == content.size()) {
+                content.resize(std::max(size_t(4096), content.size() * 2));
+            }
+
+            ssize_t result = ::pread(fd, &content[bytesRead], content.size() - bytesRead, off_t(bytesRead));
+
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                ::close(fd);
+                error = "Error while reading file";
+                return false;
+            }
+            else if (result == 0) {
+                break;
+            }
+
+            bytesRead += size_t(result);
+        }
+
+        ::close(fd);
+        content.resize(bytesRead);
+        return true;
+#else
+        std::ifstream stream(fileName, std::ios::binary);
+
+        if (!stream.is_open()) {
+            error = "Could not open file";
+            return false;
+        }
+
+        std::ostringstream contents;
+        contents << stream.rdbuf();
+        content = contents.str();
+        return true;
+#endif
+    }
+
+    SIMPLEJSON_INLINE void parseFilesWithThreadPool__internal(const std::vector<std::string>& fileNames, const size_t threadCount, std::vector<simpleJSON::BatchParseResult>& results) {
+        FUNCTRACE
+
+        constexpr size_t filesPerChunk = 16;
+
+        size_t chunkCount = (fileNames.size() + filesPerChunk - 1) / filesPerChunk;
+
+        parallelFor__internal(chunkCount, threadCount, [&](const size_t chunk) {
+            MemoryStreamBuffer__internal buffer{std::string_view{}};
+            std::istream stream(&buffer);
+            std::string content;
+
+            size_t end = std::min(fileNames.size(), (chunk + 1) * filesPerChunk);
+
+            for (size_t i = chunk * filesPerChunk; i < end; ++i) {
+                if (readWholeFile__internal(fileNames[i].c_str(), content, results[i].error)) {
+                    parseBatchDocument__internal(buffer, stream, content, results[i]);
+                }
+            }
+        });
+
+        return;
+    }
+
+#ifdef SIMPLEJSON_HAS_IO_URING
+    SIMPLEJSON_INLINE IoUring__internal::IoUring__internal()
+        : ringFd(-1), pendingSubmissions(0), submissionRing(nullptr), submissionRingSize(0), completionRing(nullptr), completionRingSize(0), 
+          submissionEntries(nullptr), submissionEntriesSize(0), submissionHead(nullptr), submissionTail(nullptr), submissionCapacity(0), 
+          submissionMask(nullptr), submissionArray(nullptr), 
+          completionHead(nullptr), completionTail(nullptr), completionMask(nullptr), completionEntries(nullptr) {
+    }
+
+    SIMPLEJSON_INLINE IoUring__internal::~IoUring__internal() {
+        if (submissionEntries) {
+            ::munmap(submissionEntries, submissionEntriesSize);
+        }
+
+        if (completionRing && completionRing != submissionRing) {
+            ::munmap(completionRing, completionRingSize);
+        }
+
+        if (submissionRing) {
+            ::munmap(submissionRing, submissionRingSize);
+        }
+
+        if (ringFd >= 0) {
+            ::close(ringFd);
+        }
+    }
+
+    SIMPLEJSON_INLINE bool IoUring__internal::setup(const unsigned entries) {
+        FUNCTRACE
+
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        ringFd = int(::syscall(__NR_io_uring_setup, entries, &params));
+
+        // the headers may be newer than the running kernel, which only supports the opcodes used here if it has this feature
+        if (ringFd < 0 || !(params.features & IORING_FEAT_RW_CUR_POS)) {
+            return false;
+        }
+
+        submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            submissionRingSize = completionRingSize = std::max(submissionRingSize, completionRingSize);
+        }
+
+        void* mapped = ::mmap(nullptr, submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+
+        submissionRing = mapped;
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            completionRing = submissionRing;
+        }
+        else {
+            mapped = ::mmap(nullptr, completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+
+            if (mapped == MAP_FAILED) {
+                return false;
+            }
+
+            completionRing = mapped;
+        }
+
+        submissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+        mapped = ::mmap(nullptr, submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+
+        submissionEntries = static_cast<io_uring_sqe*>(mapped);
+
+        char* submissionBase = static_cast<char*>(submissionRing);
+        submissionHead = reinterpret_cast<unsigned*>(submissionBase + params.sq_off.head);
+        submissionTail = reinterpret_cast<unsigned*>(submissionBase + params.sq_off.tail);
+        submissionCapacity = params.sq_entries;
+        submissionMask = reinterpret_cast<unsigned*>(submissionBase + params.sq_off.ring_mask);
+        submissionArray = reinterpret_cast<unsigned*>(submissionBase + params.sq_off.array);
+
+        char* completionBase = static_cast<char*>(completionRing);
+        completionHead = reinterpret_cast<unsigned*>(completionBase + params.cq_off.head);
+        completionTail = reinterpret_cast<unsigned*>(completionBase + params.cq_off.tail);
+        completionMask = reinterpret_cast<unsigned*>(completionBase + params.cq_off.ring_mask);
+        completionEntries = reinterpret_cast<io_uring_cqe*>(completionBase + params.cq_off.cqes);
+
+        return true;
+    }
+
+    SIMPLEJSON_INLINE io_uring_sqe* IoUring__internal::nextSubmission() {
+        // the kernel only looks at the submission ring inside io_uring_enter, so the entry may be filled after publishing it
+        unsigned tail = *submissionTail;
+
+        // entries are free again once the kernel has consumed them, which moves the head
+        while (tail - __atomic_load_n(submissionHead, __ATOMIC_ACQUIRE) >= submissionCapacity) {
+            unsigned pendingBefore = pendingSubmissions;
+            submitAndWait(0);
+
+            if (pendingSubmissions == pendingBefore) {
+                throw simpleJSON::JSONException("io_uring submission queue is full while reading files");
+            }
+        }
+
+        unsigned index = tail & *submissionMask;
+
+        io_uring_sqe* entry = &submissionEntries[index];
+        std::memset(entry, 0, sizeof(io_uring_sqe));
+        submissionArray[index] = index;
+
+        __atomic_store_n(submissionTail, tail + 1, __ATOMIC_RELEASE);
+        ++pendingSubmissions;
+        return entry;
+    }
+
+    SIMPLEJSON_INLINE void IoUring__internal::submitAndWait(const unsigned minComplete) {
+        while (true) {
+            long submitted = ::syscall(__NR_io_uring_enter, ringFd, pendingSubmissions, minComplete, minComplete ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+
+            if (submitted < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                throw simpleJSON::JSONException("io_uring_enter failed while reading files");
+            }
+
+            pendingSubmissions -= unsigned(submitted);
+            return;
+        }
+    }
+
+    SIMPLEJSON_INLINE bool IoUring__internal::popCompletion(uint64_t& userData, int& result) {
+        unsigned head = *completionHead;
+
+        if (head == __atomic_load_n(completionTail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+
+        const io_uring_cqe& entry = completionEntries[head & *completionMask];
+        userData = entry.user_data;
+        result = entry.res;
+
+        __atomic_store_n(completionHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    SIMPLEJSON_INLINE void readFilesWithIoUring__internal(IoUring__internal& ring, const std::vector<std::string>& fileNames, const size_t queueDepth, 
+                                                          BoundedQueue__internal<std::pair<size_t, std::string>>& loadedFiles, std::vector<simpleJSON::BatchParseResult>& results) {
+        FUNCTRACE
+
+        // closes are fire-and-forget, their completions carry this tag instead of a slot index
+        constexpr uint64_t closeTag = ~uint64_t(0);
+        constexpr size_t initialReadSize = 16384;
+
+        std::vector<FileReadSlot__internal> slots(queueDepth);
+        std::vector<size_t> freeSlots;
+        size_t nextFile = 0;
+        size_t inFlight = 0;
+
+        for (size_t i = queueDepth; i > 0; --i) {
+            freeSlots.push_back(i - 1);
+        }
+
+        auto submitOpen = [&](const size_t slotIndex) {
+            FileReadSlot__internal& slot = slots[slotIndex];
+            slot.fileIndex = nextFile++;
+            slot.fd = -1;
+            slot.bytesRead = 0;
+
+            io_uring_sqe* entry = ring.nextSubmission();
+            entry->opcode = IORING_OP_OPENAT;
+            entry->fd = AT_FDCWD;
+            entry->addr = reinterpret_cast<uint64_t>(fileNames[slot.fileIndex].c_str());
+            entry->open_flags = O_RDONLY | O_CLOEXEC;
+            entry->user_data = slotIndex;
+            ++inFlight;
+        };
+
+        auto submitRead = [&](const size_t slotIndex) {
+            FileReadSlot__internal& slot = slots[slotIndex];
+
+            io_uring_sqe* entry = ring.nextSubmission();
+            entry->opcode = IORING_OP_READ;
+            entry->fd = slot.fd;
+            entry->addr = reinterpret_cast<uint64_t>(&slot.buffer[slot.bytesRead]);
+            entry->len = unsigned(slot.buffer.size() - slot.bytesRead);
+            entry->off = slot.bytesRead;
+            entry->user_data = slotIndex;
+            ++inFlight;
+        };
+
+        auto finishFile = [&](const size_t slotIndex, const char* error) {
+            FileReadSlot__internal& slot = slots[slotIndex];
+
+            if (slot.fd >= 0) {
+                io_uring_sqe* entry = ring.nextSubmission();
+                entry->opcode = IORING_OP_CLOSE;
+                entry->fd = slot.fd;
+                entry->user_data = closeTag;
+                ++inFlight;
+                slot.fd = -1;
+            }
+
+            if (error) {
+                results[slot.fileIndex].error = error;
+            }
+            else {
+                slot.buffer.resize(slot.bytesRead);
+
+                if (!loadedFiles.push(std::make_pair(slot.fileIndex, std::move(slot.buffer)))) {
+                    throw simpleJSON::JSONException("File parsing stopped");
+                }
+            }
+
+            if (nextFile < fileNames.size()) {
+                submitOpen(slotIndex);
+            }
+            else {
+                freeSlots.push_back(slotIndex);
+            }
+        };
+
+        // After an error the kernel may still write into slot buffers and hand out file descriptors. Every outstanding
+        // operation is waited for before the slots are freed, and descriptors that are still open are closed.
+        auto abandonReads = [&]() {
+            try {
+                while (inFlight > 0) {
+                    ring.submitAndWait(1);
+
+                    uint64_t tag;
+                    int result;
+
+                    while (ring.popCompletion(tag, result)) {
+                        --inFlight;
+
+                        if (tag != closeTag && slots[size_t(tag)].fd < 0 && result >= 0) {
+                            slots[size_t(tag)].fd = result;
+                        }
+                    }
+                }
+            }
+            catch (const simpleJSON::JSONException&) {
+                // the ring cannot be waited on, so the buffers are leaked instead of being freed under the kernel
+                static_cast<void>(new std::vector<FileReadSlot__internal>(std::move(slots)));
+                return;
+            }
+
+            for (FileReadSlot__internal& slot : slots) {
+                if (slot.fd >= 0) {
+                    ::close(slot.fd);
+                }
+            }
+            return;
+        };
+
+        try {
+            while (true) {
+                while (!freeSlots.empty() && nextFile < fileNames.size()) {
+                    submitOpen(freeSlots.back());
+                    freeSlots.pop_back();
+                }
+
+                if (inFlight == 0) {
+                    break;
+                }
+
+                ring.submitAndWait(1);
+
+                uint64_t tag;
+                int result;
+
+                while (ring.popCompletion(tag, result)) {
+                    --inFlight;
+
+                    if (tag == closeTag) {
+                        continue;
+                    }
+
+                    size_t slotIndex = size_t(tag);
+                    FileReadSlot__internal& slot = slots[slotIndex];
+
+                    if (slot.fd < 0) {
+                        if (result < 0) {
+                            finishFile(slotIndex, "Could not open file");
+                        }
+                        else {
+                            slot.fd = result;
+                            slot.buffer.resize(initialReadSize);
+                            submitRead(slotIndex);
+                        }
+                    }
+                    else if (result < 0) {
+                        finishFile(slotIndex, "Error while reading file");
+                    }
+                    else {
+                        slot.bytesRead += size_t(result);
+
+                        // a short read of a regular file means end of file, so most files need a single read
+                        if (result == 0 || slot.bytesRead < slot.buffer.size()) {
+                            finishFile(slotIndex, nullptr);
+                        }
+                        else {
+                            slot.buffer.resize(slot.buffer.size() * 2);
+                            submitRead(slotIndex);
+                        }
+                    }
+                }
+            }
+
+            // submit the remaining closes
+            ring.submitAndWait(0);
+        }
+        catch (...) {
+            abandonReads();
+            throw;
+        }
+
+        return;
+    }
+
+    SIMPLEJSON_INLINE bool parseFilesWithIoUring__internal(const std::vector<std::string>& fileNames, const size_t threadCount, const size_t queueDepth, 
+                                                           std::vector<simpleJSON::BatchParseResult>& results) {
+        FUNCTRACE
+
+        size_t depth = std::max(size_t(1), queueDepth);
+        IoUring__internal ring;
+
+        if (!ring.setup(unsigned(2 * depth))) {
+            return false;
+        }
+
+        size_t workerCount = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+        BoundedQueue__internal<std::pair<size_t, std::string>> loadedFiles(depth);
+        std::vector<std::thread> workers;
+
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back([&]() {
+                MemoryStreamBuffer__internal buffer{std::string_view{}};
+                std::istream stream(&buffer);
+                std::pair<size_t, std::string> file;
+
+                while (loadedFiles.pop(file)) {
+                    parseBatchDocument__internal(buffer, stream, file.second, results[file.first]);
+                }
+            });
+        }
+
+        try {
+            readFilesWithIoUring__internal(ring, fileNames, depth, loadedFiles, results);
+        }
+        catch (...) {
+            loadedFiles.close();
+
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+
+            throw;
+        }
+
+        loadedFiles.close();
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        return true;
+    }
+#endif
+
+    SIMPLEJSON_INLINE MemoryStreamBuffer__internal::MemoryStreamBuffer__internal(std::string_view data) {
+        reset(data);
+    }
+
+    SIMPLEJSON_INLINE void MemoryStreamBuffer__internal::reset(std::string_view data) {
+        // the buffer is only ever read from
+        char* begin = const_cast<char*>(data.data());
+        setg(begin, begin, begin + data.size());
+        return;
+    }
+
+    SIMPLEJSON_INLINE StructReader__internal::StructReader__internal(std::string_view input) : input(input), pos(0) { FUNCTRACE }
+
+    SIMPLEJSON_INLINE char StructReader__internal::peekNextNonSpaceCharacter() {
+        while (pos < input.size() && isspace(static_cast<unsigned char>(input[pos]))) {
+            ++pos;
+        }
+
+        return pos < input.size() ? input[pos] : '\0';
+    }
+
+    SIMPLEJSON_INLINE void StructReader__internal::expect(const char c) {
+        if (peekNextNonSpaceCharacter() != c) {
+            fail("expected '" + std::string{c} + "'");
+        }
+
+        ++pos;
+        return;
+    }
+
+    SIMPLEJSON_INLINE bool StructReader__internal::consumeIf(const char c) {
+        if (peekNextNonSpaceCharacter() == c) {
+            ++pos;
+            return true;
+        }
+
+        return false;
+    }
+
+    SIMPLEJSON_INLINE std::string_view StructReader__internal::readRawString() {
+        expect('"');
+
+        size_t begin = pos;
+
+        while (pos < input.size() && input[pos] != '"') {
+            pos += input[pos] == '\\' ? 2 : 1;
+        }
+
+        if (pos >= input.size()) {
+            fail("unterminated string");
+        }
+
+        return input.substr(begin, pos++ - begin);
+    }
+
+    SIMPLEJSON_INLINE std::string_view StructReader__internal::readNumberToken() {
+        peekNextNonSpaceCharacter();
+
+        if (pos >= input.size()) {
+            fail("expected a number");
+        }
+
+        // same grammar as every other parser, so that ".5", "01" or "1." are rejected
+        size_t begin = pos;
+        StaticJSONParser__internal parser{input, pos, nullptr, 0};
+
+        try {
+            parser.parseNumber();
+        }
+        catch (const simpleJSON::JSONException&) {
+            fail("expected a number");
+        }
+
+        pos = parser.pos;
+        return input.substr(begin, pos - begin);
+    }
+
+    SIMPLEJSON_INLINE bool StructReader__internal::readBool() {
+        peekNextNonSpaceCharacter();
+
+        if (input.substr(pos, 4) == "true") {
+            pos += 4;
+            return true;
+        }
+        else if (input.substr(pos, 5) == "false") {
+            pos += 5;
+            return false;
+        }
+
+        fail("expected \"true\" or \"false\"");
+    }
+
+    SIMPLEJSON_INLINE bool StructReader__internal::readNullIfPresent() {
+        peekNextNonSpaceCharacter();
+
+        if (input.substr(pos, 4) == "null") {
+            pos += 4;
+            return true;
+        }
+
+        return false;
+    }
+
+    SIMPLEJSON_INLINE void StructReader__internal::skipValue() {
+        char next = peekNextNonSpaceCharacter();
+
+        if (next == '"') {
+            readRawString();
+        }
+        else if (next == '{' || next == '[') {
+            char close = next == '{' ? '}' : ']';
+            ++pos;
+
+            if (consumeIf(close)) {
+                return;
+            }
+
+            do {
+                if (close == '}') {
+                    readRawString();
+                    expect(':');
+                }
+                skipValue();
+            } while (consumeIf(','));
+
+            expect(close);
+        }
+        else if (next == 't' || next == 'f') {
+            readBool();
+        }
+        else if (next == 'n') {
+            if (!readNullIfPresent()) {
+                fail("expected \"null\"");
+            }
+        }
+        else {
+            readNumberToken();
+        }
+        return;
+    }
 
-            if (out == "false") {
-                return simpleJSON::JSONBool(false);
-            } 
+    SIMPLEJSON_INLINE void StructReader__internal::expectEnd() {
+        if (peekNextNonSpaceCharacter() != '\0' || pos != input.size()) {
+            fail("expected end of input");
         }
+        return;
+    }
 
-        std::string errorMessage = "Error while parsing bool, expected \"true\" or \"false\", got \"" + out + "\"";
+    SIMPLEJSON_INLINE void StructReader__internal::fail(const std::string& message) const {
+        std::string errorMessage = "Error while parsing struct, " + message + " at offset " + std::to_string(pos);
         throw simpleJSON::JSONException(errorMessage.c_str());
     }
-    
-    simpleJSON::JSONNull parseNull__internal(std::istream& stream) {
-        FUNCTRACE
 
-        char c1, c2, c3, c4;
-        stream.get(c1);
-        stream.get(c2);
-        stream.get(c3);
-        stream.get(c4);
+    SIMPLEJSON_INLINE void encodeBSONDocument__internal(simpleJSON::BinaryWriter& writer, const simpleJSON::JSONObject& obj) {
+        // the document length is only known once its elements are written, so it is back-patched
+        size_t documentStart = writer.position();
+        writer.writeLittleEndian(int32_t(0));
 
-        std::string out = {c1, c2, c3, c4};
+        if (obj.isMap()) {
+            for (auto& [key, val] : obj.asMap()) {
+                encodeBSONElement__internal(writer, unescapeString__internal(key.getString()), val);
+            }
+        }
+        else {
+            size_t i = 0;
 
-        if (out != "null") {
-            std::string errorMessage = "Error while parsing null, expected \"null\", got \"" + out + "\"";
-            throw simpleJSON::JSONException(errorMessage.c_str());
+            obj.asArray().forEach([&](const simpleJSON::JSONObject& elem) {
+                encodeBSONElement__internal(writer, std::to_string(i++), elem);
+            });
         }
 
-        return simpleJSON::JSONNull{};
-    }
+        writer.writeByte(0x00);
 
-    simpleJSON::JSONArray parseArray__internal(std::istream& stream) {
-        FUNCTRACE
+        size_t documentLength = writer.position() - documentStart;
 
-        char c;
-        stream.get(c);
+        if (documentLength > size_t(INT32_MAX)) {
+            throw simpleJSON::JSONException("Document is too large to be encoded as BSON");
+        }
 
-        if (c != '[') {
-            std::string errorMessage = "Error while parsing array, expected '[', got '" + std::string{c} + "'";
-            throw simpleJSON::JSONException(errorMessage.c_str());
+        writer.patchLittleEndian(documentStart, int32_t(documentLength));
+        return;
+    }
+
+    SIMPLEJSON_INLINE void encodeBSONElement__internal(simpleJSON::BinaryWriter& writer, const std::string& key, const simpleJSON::JSONObject& obj) {
+        if (key.find('\0') != std::string::npos) {
+            throw simpleJSON::JSONException("BSON keys cannot contain NUL characters");
         }
 
-        simpleJSON::JSONArray result;
+        auto writeKey = [&](uint8_t type) {
+            writer.writeByte(type);
+            writer.writeBytes(key.c_str(), key.size() + 1);
+        };
 
-        bool expectingComma = false;
-        bool lastReadWasComma = false;
+        if (obj.isString()) {
+            std::string str = unescapeString__internal(obj.asString().getString());
 
-        while (stream) {
-            c = peekNextNonSpaceCharacter__internal(stream);
+            if (str.size() >= size_t(INT32_MAX)) {
+                throw simpleJSON::JSONException("String is too long to be encoded as BSON");
+            }
 
-            if (c == ',') {
-                if (expectingComma) {
-                    stream.get(c);
-                    expectingComma = false;
-                    lastReadWasComma = true;
-                    continue;
+            writeKey(0x02);
+            writer.writeLittleEndian(int32_t(str.size() + 1));
+            writer.writeBytes(str.c_str(), str.size() + 1);
+        }
+        else if (obj.isNumber()) {
+            auto& num = obj.asNumber();
+
+            if (num.isIntegral()) {
+                simpleJSON::JSONIntegral val = num.getIntegral();
+
+                if (val >= INT32_MIN && val <= INT32_MAX) {
+                    writeKey(0x10);
+                    writer.writeLittleEndian(int32_t(val));
                 }
                 else {
-                    throw simpleJSON::JSONException("Unexpected comma when parsing array");
+                    writeKey(0x12);
+                    writer.writeLittleEndian(int64_t(val));
                 }
             }
+            else {
+                double val = double(num.getFloating());
+                uint64_t bits;
+                std::memcpy(&bits, &val, sizeof(bits));
 
-            if (c == ']') {
-                if (lastReadWasComma) {
-                    throw simpleJSON::JSONException("Trailing comma not allowed in array");
-                }
-                else {
-                    stream.get(c);
-                    return result;
-                }
+                writeKey(0x01);
+                writer.writeLittleEndian(bits);
             }
+        }
+        else if (obj.isBool()) {
+            writeKey(0x08);
+            writer.writeByte(obj.asBool().getBoolean() ? 0x01 : 0x00);
+        }
+        else if (obj.isNull()) {
+            writeKey(0x0A);
+        }
+        else if (obj.isArray()) {
+            writeKey(0x04);
+            encodeBSONDocument__internal(writer, obj);
+        }
+        else {
+            writeKey(0x03);
+            encodeBSONDocument__internal(writer, obj);
+        }
+        return;
+    }
 
-            NextJsonType nextType = detectNextType__internal(c);
-            
-            switch (nextType) {
-                case NextJsonType::JSON_STRING: 
-                    result.append(parseString__internal(stream));
+    SIMPLEJSON_INLINE simpleJSON::JSONObject decodeBSONDocument__internal(simpleJSON::BinaryReader& reader, const bool isArray, const size_t depth) {
+        if (depth >= simpleJSON::BSONCodec::maxDepth) {
+            throw simpleJSON::JSONException("Error while decoding BSON, documents nested too deeply");
+        }
+
+        size_t documentStart = reader.position();
+        int32_t documentLength = reader.readLittleEndian<int32_t>();
+
+        if (documentLength < 5) {
+            throw simpleJSON::JSONException("Error while decoding BSON, invalid document length");
+        }
+
+        simpleJSON::JSONObject result = isArray ? simpleJSON::JSONObject(simpleJSON::JSONArray{}) : simpleJSON::JSONObject{};
+
+        while (true) {
+            uint8_t type = reader.readByte();
+
+            if (type == 0x00) {
+                break;
+            }
+
+            std::string key;
+            for (char c = char(reader.readByte()); c != '\0'; c = char(reader.readByte())) {
+                key += c;
+            }
+
+            simpleJSON::JSONObject value;
+
+            switch (type) {
+                case 0x01: {
+                    uint64_t bits = reader.readLittleEndian<uint64_t>();
+                    double val;
+                    std::memcpy(&val, &bits, sizeof(val));
+                    value = simpleJSON::JSONFloating(val);
                     break;
-                case NextJsonType::JSON_NUMBER:
-                    result.append(parseNumber__internal(stream));
+                }
+                case 0x02: {
+                    int32_t length = reader.readLittleEndian<int32_t>();
+
+                    if (length < 1) {
+                        throw simpleJSON::JSONException("Error while decoding BSON, invalid string length");
+                    }
+
+                    std::string_view str = reader.readBytes(size_t(length));
+
+                    if (str.back() != '\0') {
+                        throw simpleJSON::JSONException("Error while decoding BSON, string is not NUL terminated");
+                    }
+
+                    value = simpleJSON::JSONString(escapeString__internal(str.substr(0, str.size() - 1)));
                     break;
-                case NextJsonType::JSON_BOOL:
-                    result.append(parseBool__internal(stream));
+                }
+                case 0x03:
+                    value = decodeBSONDocument__internal(reader, false, depth + 1);
                     break;
-                case NextJsonType::JSON_NULL:
-                    result.append(parseNull__internal(stream));
+                case 0x04:
+                    value = decodeBSONDocument__internal(reader, true, depth + 1);
                     break;
-                case NextJsonType::JSON_ARRAY:
-                    result.append(parseArray__internal(stream));
+                case 0x08:
+                    value = reader.readByte() != 0x00;
                     break;
-                case NextJsonType::JSON_OBJECT:
-                    result.append(parseObject__internal(stream));
+                case 0x0A:
+                    value = simpleJSON::JSONNull{};
                     break;
-                case NextJsonType::JSON_END_OF_STREAM:
-                    // next read will fail and function will end
+                case 0x10:
+                    value = reader.readLittleEndian<int32_t>();
                     break;
-                default: 
-                    std::string errorMessage = "Error while parsing array, unexpected next character '" + std::string{c} + "'"; 
-                    throw simpleJSON::JSONException(errorMessage.c_str());
+                case 0x12:
+                    value = simpleJSON::JSONIntegral(reader.readLittleEndian<int64_t>());
                     break;
+                default:
+                    std::string errorMessage = "Error while decoding BSON, unsupported element type " + std::to_string(type);
+                    throw simpleJSON::JSONException(errorMessage.c_str());
             }
 
-            expectingComma = true;
-            lastReadWasComma = false;
+            if (isArray) {
+                result.append(std::move(value));
+            }
+            else {
+                result[simpleJSON::JSONString(escapeString__internal(key))] = std::move(value);
+            }
         }
 
-        // should not get here
-        std::string errorMessage = "Error while parsing array, unexpected end of stream";
-        throw simpleJSON::JSONException(errorMessage.c_str());
-    }
-
-    simpleJSON::JSONObject parseObject__internal(std::istream& stream) {
-        FUNCTRACE
+        if (reader.position() - documentStart != size_t(documentLength)) {
+            throw simpleJSON::JSONException("Error while decoding BSON, document length does not match its contents");
+        }
 
-        char next;
-        stream.get(next);
+        return result;
+    }
 
-        if (next != '{') {
-            std::string errorMessage = "Error while parsing object, expected '{', got '" + std::string{next} + "'";
-            throw simpleJSON::JSONException(errorMessage.c_str());
+    SIMPLEJSON_INLINE void encodeUBJSONValue__internal(simpleJSON::BinaryWriter& writer, const simpleJSON::JSONObject& obj) {
+        if (obj.isString()) {
+            writer.writeByte('S');
+            encodeUBJSONString__internal(writer, unescapeString__internal(obj.asString().getString()));
         }
+        else if (obj.isNumber()) {
+            auto& num = obj.asNumber();
 
-        simpleJSON::JSONObject result;
-
-        bool lastReadWasComma = false;
+            if (num.isIntegral()) {
+                char marker = smallestUBJSONIntegerMarker__internal(num.getIntegral(), num.getIntegral());
+                writer.writeByte(marker);
+                encodeUBJSONInteger__internal(writer, marker, num.getIntegral());
+            }
+            else {
+                double val = double(num.getFloating());
+                uint64_t bits;
+                std::memcpy(&bits, &val, sizeof(bits));
 
-        while (stream) {
-            next = peekNextNonSpaceCharacter__internal(stream);
+                writer.writeByte('D');
+                writer.writeBigEndian(bits);
+            }
+        }
+        else if (obj.isBool()) {
+            writer.writeByte(obj.asBool().getBoolean() ? 'T' : 'F');
+        }
+        else if (obj.isNull()) {
+            writer.writeByte('Z');
+        }
+        else if (obj.isArray()) {
+            auto& arr = obj.asArray();
+
+            bool allIntegral = arr.size() > 0;
+            bool allFloating = arr.size() > 0;
+            bool first = true;
+            simpleJSON::JSONIntegral minVal = 0;
+            simpleJSON::JSONIntegral maxVal = 0;
+
+            arr.forEach([&](const simpleJSON::JSONObject& elem) {
+                if (!elem.isNumber()) {
+                    allIntegral = false;
+                    allFloating = false;
+                }
+                else if (elem.asNumber().isIntegral()) {
+                    allFloating = false;
 
-            if (next == '}') {
-                if (lastReadWasComma) {
-                    throw simpleJSON::JSONException("Trailing comma not allowed in object");
+                    simpleJSON::JSONIntegral val = elem.asNumber().getIntegral();
+                    minVal = first ? val : std::min(minVal, val);
+                    maxVal = first ? val : std::max(maxVal, val);
                 }
-                stream.get();
-                return result;
+                else {
+                    allIntegral = false;
+                }
+                first = false;
+            });
+
+            writer.writeByte('[');
+
+            if (allIntegral || allFloating) {
+                char elementMarker = allIntegral ? smallestUBJSONIntegerMarker__internal(minVal, maxVal) : 'D';
+                simpleJSON::JSONIntegral count = simpleJSON::JSONIntegral(arr.size());
+                char countMarker = smallestUBJSONIntegerMarker__internal(count, count);
+
+                writer.writeByte('$');
+                writer.writeByte(elementMarker);
+                writer.writeByte('#');
+                writer.writeByte(countMarker);
+                encodeUBJSONInteger__internal(writer, countMarker, count);
+
+                arr.forEach([&](const simpleJSON::JSONObject& elem) {
+                    if (allIntegral) {
+                        encodeUBJSONInteger__internal(writer, elementMarker, elem.asNumber().getIntegral());
+                    }
+                    else {
+                        double val = double(elem.asNumber().getFloating());
+                        uint64_t bits;
+                        std::memcpy(&bits, &val, sizeof(bits));
+                        writer.writeBigEndian(bits);
+                    }
+                });
             }
+            else {
+                arr.forEach([&](const simpleJSON::JSONObject& elem) {
+                    encodeUBJSONValue__internal(writer, elem);
+                });
 
-            lastReadWasComma = false;
+                writer.writeByte(']');
+            }
+        }
+        else {
+            writer.writeByte('{');
 
-            // must read string as map key if object is not empty
-            if (next != '"') {
-                std::string errorMessage = "Error while parsing object, expected '\"', got '" + std::string{next} + "'";
-                throw simpleJSON::JSONException(errorMessage.c_str());
+            for (auto& [key, val] : obj.asMap()) {
+                encodeUBJSONString__internal(writer, unescapeString__internal(key.getString()));
+                encodeUBJSONValue__internal(writer, val);
             }
 
-            simpleJSON::JSONString key = parseString__internal(stream);
+            writer.writeByte('}');
+        }
+        return;
+    }
 
-            // possible white space between map key and :
-            next = peekNextNonSpaceCharacter__internal(stream);
-            stream.get(next);
+    SIMPLEJSON_INLINE char smallestUBJSONIntegerMarker__internal(const simpleJSON::JSONIntegral minVal, const simpleJSON::JSONIntegral maxVal) {
+        if (minVal >= INT8_MIN && maxVal <= INT8_MAX) {
+            return 'i';
+        }
+        else if (minVal >= 0 && maxVal <= UINT8_MAX) {
+            return 'U';
+        }
+        else if (minVal >= INT16_MIN && maxVal <= INT16_MAX) {
+            return 'I';
+        }
+        else if (minVal >= INT32_MIN && maxVal <= INT32_MAX) {
+            return 'l';
+        }
+        else {
+            return 'L';
+        }
+    }
 
-            // must read separator
-            if (next != ':') {
-                std::string errorMessage = "Error while parsing object, expected ':', got '" + std::string{next} + "'";
-                throw simpleJSON::JSONException(errorMessage.c_str());
-            }
+    SIMPLEJSON_INLINE void encodeUBJSONInteger__internal(simpleJSON::BinaryWriter& writer, const char marker, const simpleJSON::JSONIntegral val) {
+        switch (marker) {
+            case 'i':   writer.writeBigEndian(int8_t(val)); break;
+            case 'U':   writer.writeBigEndian(uint8_t(val)); break;
+            case 'I':   writer.writeBigEndian(int16_t(val)); break;
+            case 'l':   writer.writeBigEndian(int32_t(val)); break;
+            case 'L':   writer.writeBigEndian(int64_t(val)); break;
+            default:    throw simpleJSON::JSONException("Invalid UBJSON integer marker");
+        }
+        return;
+    }
 
-            // possible white space between : and map value
-            next = peekNextNonSpaceCharacter__internal(stream);
+    SIMPLEJSON_INLINE void encodeUBJSONString__internal(simpleJSON::BinaryWriter& writer, const std::string& str) {
+        simpleJSON::JSONIntegral length = simpleJSON::JSONIntegral(str.size());
+        char lengthMarker = smallestUBJSONIntegerMarker__internal(length, length);
 
-            NextJsonType nextType = detectNextType__internal(next);
-            
-            switch (nextType) {
-                case NextJsonType::JSON_STRING:
-                    result[key] = parseString__internal(stream);
-                    break;
-                case NextJsonType::JSON_NUMBER:
-                    result[key] = parseNumber__internal(stream);
-                    break;
-                case NextJsonType::JSON_BOOL:
-                    result[key] = parseBool__internal(stream);
-                    break;
-                case NextJsonType::JSON_NULL:
-                    result[key] = parseNull__internal(stream);
-                    break;
-                case NextJsonType::JSON_ARRAY:
-                    result[key] = parseArray__internal(stream);
-                    break;
-                case NextJsonType::JSON_OBJECT:
-                    result[key] = parseObject__internal(stream);
-                    break;
-                case NextJsonType::JSON_END_OF_STREAM:
-                    // next read will fail and function will end
-                    break;
-                default: 
-                    std::string errorMessage = "Error while parsing object, unexpected next character '" + std::string{next} + "'"; 
-                    throw simpleJSON::JSONException(errorMessage.c_str());
-                    break;
+        writer.writeByte(lengthMarker);
+        encodeUBJSONInteger__internal(writer, lengthMarker, length);
+        writer.writeBytes(str.data(), str.size());
+        return;
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONObject decodeUBJSONValue__internal(simpleJSON::BinaryReader& reader, char marker, const size_t depth) {
+        switch (marker) {
+            case 'Z':
+                return simpleJSON::JSONObject(simpleJSON::JSONNull{});
+            case 'T':
+                return simpleJSON::JSONObject(true);
+            case 'F':
+                return simpleJSON::JSONObject(false);
+            case 'i': [[fallthrough]];
+            case 'U': [[fallthrough]];
+            case 'I': [[fallthrough]];
+            case 'l': [[fallthrough]];
+            case 'L':
+                return simpleJSON::JSONObject(decodeUBJSONInteger__internal(reader, marker));
+            case 'd': {
+                uint32_t bits = reader.readBigEndian<uint32_t>();
+                float val;
+                std::memcpy(&val, &bits, sizeof(val));
+                return simpleJSON::JSONObject(simpleJSON::JSONFloating(val));
+            }
+            case 'D': {
+                uint64_t bits = reader.readBigEndian<uint64_t>();
+                double val;
+                std::memcpy(&val, &bits, sizeof(val));
+                return simpleJSON::JSONObject(simpleJSON::JSONFloating(val));
             }
+            case 'H': {
+                std::string number = decodeUBJSONString__internal(reader);
 
-            //  possible white space between map value and , or }
-            next = peekNextNonSpaceCharacter__internal(stream);
-            stream.get(next);
-            
-            if (next == ',') {
-                lastReadWasComma = true;
-                continue;
+                if (number.find_first_of(".eE") != std::string::npos) {
+                    return simpleJSON::JSONObject(strToJSONFloating__internal(number));
+                }
+                else {
+                    return simpleJSON::JSONObject(strToJSONIntegral__internal(number));
+                }
             }
-            else if (next == '}') {
-                break;
+            case 'C':
+                return simpleJSON::JSONObject(simpleJSON::JSONString(escapeString__internal(reader.readBytes(1))));
+            case 'S':
+                return simpleJSON::JSONObject(simpleJSON::JSONString(escapeString__internal(decodeUBJSONString__internal(reader))));
+            case '[': [[fallthrough]];
+            case '{': {
+                if (depth >= simpleJSON::UBJSONCodec::maxDepth) {
+                    throw simpleJSON::JSONException("Error while decoding UBJSON, containers nested too deeply");
+                }
+
+                bool isArray = marker == '[';
+                char elementMarker = '\0';
+                simpleJSON::JSONIntegral count = -1;
+
+                if (reader.peekByte() == '$') {
+                    reader.readByte();
+                    elementMarker = char(reader.readByte());
+
+                    if (reader.peekByte() != '#') {
+                        throw simpleJSON::JSONException("Error while decoding UBJSON, typed container must specify a count");
+                    }
+                }
+
+                if (reader.peekByte() == '#') {
+                    reader.readByte();
+                    count = decodeUBJSONInteger__internal(reader, char(reader.readByte()));
+
+                    // every element takes at least one byte, except the elements of typed null/true/false arrays
+                    bool hasPayload = !isArray || (elementMarker != 'Z' && elementMarker != 'T' && elementMarker != 'F');
+                    size_t maxCount = hasPayload ? reader.remaining() : (reader.remaining() + 1) * simpleJSON::UBJSONCodec::maxEmptyElementsPerByte;
+
+                    if (count < 0 || size_t(count) > maxCount) {
+                        throw simpleJSON::JSONException("Error while decoding UBJSON, invalid container count");
+                    }
+                }
+
+                simpleJSON::JSONObject result = isArray ? simpleJSON::JSONObject(simpleJSON::JSONArray{}) : simpleJSON::JSONObject{};
+
+                auto nextMarker = [&]() {
+                    if (elementMarker != '\0') {
+                        return elementMarker;
+                    }
+
+                    char next = char(reader.readByte());
+                    while (next == 'N') {
+                        next = char(reader.readByte());
+                    }
+                    return next;
+                };
+
+                for (simpleJSON::JSONIntegral i = 0; count < 0 || i < count; ++i) {
+                    if (count < 0) {
+                        while (reader.peekByte() == 'N') {
+                            reader.readByte();
+                        }
+
+                        if (reader.peekByte() == (isArray ? ']' : '}')) {
+                            reader.readByte();
+                            break;
+                        }
+                    }
+
+                    if (isArray) {
+                        result.append(decodeUBJSONValue__internal(reader, nextMarker(), depth + 1));
+                    }
+                    else {
+                        simpleJSON::JSONString key(escapeString__internal(decodeUBJSONString__internal(reader)));
+                        result[key] = decodeUBJSONValue__internal(reader, nextMarker(), depth + 1);
+                    }
+                }
+
+                return result;
             }
-            else {
-                std::string errorMessage = "Error while parsing object, unexpected next character '" + std::string{next} + "'"; 
+            default:
+                std::string errorMessage = "Error while decoding UBJSON, unexpected marker '" + std::string{marker} + "'";
                 throw simpleJSON::JSONException(errorMessage.c_str());
-            }
         }
-        
-        return result;
+    }
+
+    SIMPLEJSON_INLINE simpleJSON::JSONIntegral decodeUBJSONInteger__internal(simpleJSON::BinaryReader& reader, const char marker) {
+        switch (marker) {
+            case 'i':   return reader.readBigEndian<int8_t>();
+            case 'U':   return reader.readBigEndian<uint8_t>();
+            case 'I':   return reader.readBigEndian<int16_t>();
+            case 'l':   return reader.readBigEndian<int32_t>();
+            case 'L':   return reader.readBigEndian<int64_t>();
+            default:    throw simpleJSON::JSONException("Error while decoding UBJSON, expected an integer marker");
+        }
+    }
+
+    SIMPLEJSON_INLINE std::string decodeUBJSONString__internal(simpleJSON::BinaryReader& reader) {
+        simpleJSON::JSONIntegral length = decodeUBJSONInteger__internal(reader, char(reader.readByte()));
+
+        if (length < 0) {
+            throw simpleJSON::JSONException("Error while decoding UBJSON, negative string length");
+        }
+
+        return std::string(reader.readBytes(size_t(length)));
     }
 } // namespace internal
 
+#endif // SIMPLEJSON_DEFINE_NON_TEMPLATES
+
 #endif //__SIMPLE_JSON__
\ No newline at end of file
@@ -1,9 +1,97 @@
+// 'make traits' runs the tests with value types other than the defaults
+#ifdef SIMPLEJSON_TEST_CUSTOM_TRAITS
+#include <map>
+
+template <typename Key, typename Value, typename Compare>
+class TestObjectMap : public std::map<Key, Value, Compare> {
+    public:
+        using std::map<Key, Value, Compare>::map;
+};
+
+struct TestJSONTraits {
+    using Floating = double;
+    using Integral = long int;
+    template <typename Key, typename Value, typename Compare>
+    using ObjectMap = TestObjectMap<Key, Value, Compare>;
+};
+
+#define SIMPLEJSON_TRAITS TestJSONTraits
+#endif
+
 #include "simpleJSON.hpp"
 
 #include <cmath>
+#include <cstdio>
 #include <cassert>
 
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+struct BoundActor {
+    long long id = 0;
+    std::string login;
+};
+
+struct BoundEvent {
+    std::string id;
+    std::string type;
+    BoundActor actor;
+    bool isPublic = false;
+    std::optional<BoundActor> org;
+};
+
+struct BoundSample {
+    int count = 0;
+    double ratio = 0;
+    std::string text;
+    std::vector<int> values;
+    std::vector<bool> flags;
+    std::optional<std::string> note;
+    std::vector<BoundActor> actors;
+};
+
+struct BoundNumbers {
+    unsigned long long counter = 0;
+    double tiny = 0;
+    float ratio = 0;
+};
+
+template <> struct simpleJSON::JSONBinding<BoundActor> {
+    static constexpr auto fields = std::make_tuple(SIMPLEJSON_FIELD(BoundActor, id), SIMPLEJSON_FIELD(BoundActor, login));
+};
+
+template <> struct simpleJSON::JSONBinding<BoundEvent> {
+    static constexpr auto fields = std::make_tuple(
+            SIMPLEJSON_FIELD(BoundEvent, id), 
+            SIMPLEJSON_FIELD(BoundEvent, type), 
+            SIMPLEJSON_FIELD(BoundEvent, actor), 
+            simpleJSON::bindField("public", &BoundEvent::isPublic), 
+            SIMPLEJSON_FIELD(BoundEvent, org)
+        );
+};
+
+template <> struct simpleJSON::JSONBinding<BoundSample> {
+    static constexpr auto fields = std::make_tuple(
+            SIMPLEJSON_FIELD(BoundSample, count), 
+            SIMPLEJSON_FIELD(BoundSample, ratio), 
+            SIMPLEJSON_FIELD(BoundSample, text), 
+            SIMPLEJSON_FIELD(BoundSample, values), 
+            SIMPLEJSON_FIELD(BoundSample, flags), 
+            SIMPLEJSON_FIELD(BoundSample, note), 
+            SIMPLEJSON_FIELD(BoundSample, actors)
+        );
+};
+
+template <> struct simpleJSON::JSONBinding<BoundNumbers> {
+    static constexpr auto fields = std::make_tuple(
+            SIMPLEJSON_FIELD(BoundNumbers, counter), 
+            SIMPLEJSON_FIELD(BoundNumbers, tiny), 
+            SIMPLEJSON_FIELD(BoundNumbers, ratio)
+        );
+};
 
 // helper function for comparing floats
 template <typename T, typename V>
@@ -49,6 +137,15 @@ void testJSONString() {
 void testJSONNumber() {
     using namespace simpleJSON;
 
+#ifdef SIMPLEJSON_TEST_CUSTOM_TRAITS
+    static_assert(std::is_same_v<JSONTraits, TestJSONTraits>);
+    static_assert(std::is_same_v<JSONFloating, double> && std::is_same_v<JSONIntegral, long int>);
+    static_assert(std::is_same_v<JSONMap, TestObjectMap<JSONString, JSONObject, JSONKeyLess>>);
+#else
+    static_assert(std::is_same_v<JSONTraits, DefaultJSONTraits>);
+    static_assert(std::is_same_v<JSONMap, std::map<JSONString, JSONObject, JSONKeyLess>>);
+#endif
+
     JSONFloating f1 = 0.22e13;
     JSONIntegral ud1 = 123;
     JSONIntegral sd1 = -123;
@@ -190,6 +287,458 @@ void testJSONArray() {
     assert(arr2[0] >= tmp[0]);
 }
 
+void testPackedArrays() {
+    using namespace simpleJSON;
+
+    JSONArray ints;
+    ints.append(1);
+    ints.append(JSONNumber(2));
+    ints.append(JSONObject(3));                                 assert(ints.isPacked() && ints.size() == 3);
+    ints.pop();                                                 assert(ints.isPacked() && ints.size() == 2);
+    assert(ints == JSONArray({1, 2}));
+    assert(ints.toString() == "[1,2]");
+
+    JSONArray floats = {0.5, 1.5};                              assert(floats.isPacked());
+    floats.append(2);                                           assert(!floats.isPacked() && floats.size() == 3);
+    assert(floats == JSONArray({0.5, 1.5, 2}));
+
+    JSONArray mixed = {1, "str"};                               assert(!mixed.isPacked());
+    mixed.clear();
+    mixed.append(-4);                                           assert(mixed.isPacked());
+
+    // element references unpack the array, values stay the same
+    JSONArray packed = {1, 2, 3};
+    JSONArray unpacked = packed;
+    unpacked[0] = 1;                                            assert(packed.isPacked() && !unpacked.isPacked());
+    assert(packed == unpacked && unpacked == packed);
+    unpacked[2] = "three";                                      assert(packed != unpacked);
+
+    size_t count = 0;
+    JSONIntegral sum = 0;
+    packed.forEach([&](const JSONObject& elem) { ++count; sum += elem.asNumber().getIntegral(); });
+    assert(count == 3 && sum == 6 && packed.isPacked());
+
+    std::string nested = "[[1, 2, 3], [0.5, -1e3], [1, 0.5]]";
+    auto parsed = parseFromString(nested);
+    assert(parsed[0].asArray().isPacked() && parsed[1].asArray().isPacked() && !parsed[2].asArray().isPacked());
+}
+
+void testArrayAggregation() {
+    using namespace simpleJSON;
+
+    JSONArray ints;
+    for (int i = 1; i <= 1000; ++i) {
+        ints.append(i % 2 == 0 ? i : -i);
+    }
+    assert(ints.isPacked());
+    assert(ints.sum() == 500);
+    assert(ints.min() == -999);
+    assert(ints.max() == 1000);
+    assert(equals(ints.mean(), 0.5));
+
+    JSONArray floats = {0.5, 2.5, -1.0};
+    assert(equals(floats.sum().getFloating(), 2.0));
+    assert(equals(floats.min().getFloating(), -1.0));
+    assert(equals(floats.max().getFloating(), 2.5));
+
+    JSONArray mixed = {1, 2.5, JSONNumber(-3)};                 assert(!mixed.isPacked());
+    assert(equals(mixed.sum().getFloating(), 0.5));
+    assert(mixed.min() == -3);
+    assert(equals(mixed.max().getFloating(), 2.5));
+    assert(JSONArray({1, 2}).sum().getIntegral() == 3);
+    assert(JSONArray{}.sum() == 0);
+
+    // overflowing integer sums are computed in floating point instead of wrapping
+    constexpr JSONIntegral maxIntegral = std::numeric_limits<JSONIntegral>::max();
+    constexpr JSONIntegral minIntegral = std::numeric_limits<JSONIntegral>::min();
+    JSONArray large = {maxIntegral, maxIntegral, 0.5};          assert(!large.isPacked());
+    assert(large.sum().getFloating() == JSONFloating(maxIntegral) * 2 + JSONFloating(0.5));
+    assert(large.mean() == (JSONFloating(maxIntegral) * 2 + JSONFloating(0.5)) / 3);
+    JSONArray overflowing;
+    overflowing.append(maxIntegral);
+    overflowing.append(1);                                      assert(overflowing.isPacked());
+    assert(overflowing.sum().isFloating() && equals(overflowing.sum().getFloating(), JSONFloating(maxIntegral) + 1));
+    JSONArray extremes;
+    for (int i = 0; i < 37; ++i) {
+        extremes.append(i % 2 == 0 ? maxIntegral : minIntegral);
+    }
+    assert(extremes.sum().isIntegral() && extremes.sum() == maxIntegral - 18);
+    extremes.append(minIntegral);
+    assert(extremes.sum().isIntegral() && extremes.sum() == -19);
+    extremes.append(minIntegral + 19);
+    assert(extremes.sum().isIntegral() && extremes.sum() == minIntegral);
+    extremes.append(-1);
+    assert(extremes.sum().isFloating());
+
+    // packed and unpacked storage follow the same rule, down to the rounding of floating point sums
+    auto unpackedCopy = [](const JSONArray& arr) {
+        JSONArray copy = arr;
+        copy[0];
+        assert(!copy.isPacked());
+        return copy;
+    };
+    auto packedArray = [](std::initializer_list<JSONNumber> elems) {
+        JSONArray arr;
+        for (auto& elem : elems) {
+            if (elem.isIntegral()) {
+                arr.append(elem.getIntegral());
+            }
+            else {
+                arr.append(elem.getFloating());
+            }
+        }
+        assert(arr.isPacked());
+        return arr;
+    };
+    for (const JSONArray& packed : {packedArray({maxIntegral, 1, -1}), packedArray({maxIntegral, 1}), packedArray({minIntegral, -1, 1}), 
+                                    extremes, ints, packedArray({1e16, 1.0, -1e16, 1.0, 3.0}), packedArray({0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7}), 
+                                    packedArray({-0.0})}) {
+        JSONArray unpacked = unpackedCopy(packed);
+        JSONNumber packedSum = packed.sum();
+        JSONNumber unpackedSum = unpacked.sum();
+
+        assert(packedSum.isIntegral() == unpackedSum.isIntegral());
+        if (packedSum.isIntegral()) {
+            assert(packedSum.getIntegral() == unpackedSum.getIntegral());
+        }
+        else {
+            assert(packedSum.getFloating() == unpackedSum.getFloating());
+            assert(std::signbit(packedSum.getFloating()) == std::signbit(unpackedSum.getFloating()));
+        }
+        assert(packed.mean() == unpacked.mean());
+    }
+    // the exact total decides, not the running sum
+    assert(unpackedCopy(packedArray({maxIntegral, 1, -1})).sum().isIntegral());
+    assert(unpackedCopy(packedArray({maxIntegral, 1, -1})).sum() == maxIntegral);
+
+    std::vector<size_t> buckets = JSONArray({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}).histogram(0, 10, 5);
+    assert((buckets == std::vector<size_t>{2, 2, 2, 2, 3}));
+
+    bool threw = false;
+    try { JSONArray({1, "str"}).sum(); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    threw = false;
+    try { JSONArray{}.min(); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+}
+
+void testJSONPointer() {
+    using namespace simpleJSON;
+
+    JSONObject obj{
+            {"a/b", 1},
+            {"m~n", 2},
+            {"list", JSONArray{JSONObject{{"x", "y"}}, 5}}
+        };
+
+    assert(*JSONPointer("").resolve(obj) == obj);
+    assert(*JSONPointer("/a~1b").resolve(obj) == 1);
+    assert(*JSONPointer("/m~0n").resolve(obj) == 2);
+    assert(*JSONPointer("/list/0/x").resolve(obj) == "y");
+    assert(*JSONPointer("/list/1").resolve(obj) == 5);
+    assert(JSONPointer("/list/2").resolve(obj) == nullptr);
+    assert(JSONPointer("/list/01").resolve(obj) == nullptr);
+    assert(JSONPointer("/missing").resolve(obj) == nullptr);
+    assert(obj.getNumberOfFields() == 3);
+    assert(JSONPointer("/a~1b/~0").toString() == "/a~1b/~0");
+
+    bool threw = false;
+    try { JSONPointer("no/leading/slash"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+}
+
+void testArrayIndex() {
+    using namespace simpleJSON;
+
+    JSONArray events = {
+            JSONObject{{"id", "a"}, {"actor", JSONObject{{"login", "x"}}}, {"n", 3}},
+            JSONObject{{"id", "b"}, {"actor", JSONObject{{"login", "y"}}}, {"n", 1}},
+            JSONObject{{"id", "c"}, {"actor", JSONObject{{"login", "x"}}}, {"n", 2}},
+            JSONObject{{"noId", true}}
+        };
+
+    events.buildIndex("/id");
+    events.buildIndex("/actor/login");
+    events.buildIndex("/n", true);
+    assert(events.hasIndex("/id") && !events.hasIndex("/other"));
+
+    assert((events.findByKey("/id", "b") == std::vector<size_t>{1}));
+    assert((events.findByKey("/actor/login", "x") == std::vector<size_t>{0, 2}));
+    assert(events.findByKey("/id", "zzz").empty());
+    assert((events.findByKeyRange("/n", 2, 3) == std::vector<size_t>{2, 0}));
+
+    events.append(JSONObject{{"id", "d"}, {"actor", JSONObject{{"login", "x"}}}, {"n", 0}});
+    assert((events.findByKey("/id", "d") == std::vector<size_t>{4}));
+    assert((events.findByKey("/actor/login", "x") == std::vector<size_t>{0, 2, 4}));
+    assert((events.findByKeyRange("/n", 0, 1) == std::vector<size_t>{4, 1}));
+
+    events.pop();
+    assert(events.findByKey("/id", "d").empty());
+    assert((events.findByKeyRange("/n", 0, 1) == std::vector<size_t>{1}));
+
+    JSONArray numbers = {5, 7, 5};
+    numbers.buildIndex("");
+    assert((numbers.findByKey("", 5) == std::vector<size_t>{0, 2}) && numbers.isPacked());
+
+    events.clear();
+    assert(events.hasIndex("/id") && events.findByKey("/id", "a").empty());
+    events.dropIndex("/id");
+
+    bool threw = false;
+    try { events.findByKey("/id", "a"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    threw = false;
+    try { events.findByKeyRange("/actor/login", "a", "z"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    JSONObject big = parseFromFile("testInputs/mediumJson.json");
+    JSONArray& bigArr = big.asArray();
+    bigArr.buildIndex("/id");
+    std::vector<size_t> found = bigArr.findByKey("/id", "2489651045");
+    assert(found.size() == 1 && bigArr[found[0]]["id"] == "2489651045");
+}
+
+void testArraySort() {
+    using namespace simpleJSON;
+
+    JSONArray people = {
+            JSONObject{{"name", "c"}, {"age", 30}},
+            JSONObject{{"name", "a"}, {"age", 25}},
+            JSONObject{{"name", "b"}, {"age", 30}},
+            JSONObject{{"name", "d"}, {"age", 20.5}}
+        };
+
+    people.sortBy("/name");
+    assert(people[0]["name"] == "a" && people[1]["name"] == "b" && people[2]["name"] == "c" && people[3]["name"] == "d");
+
+    // stable: equal ages keep their current relative order
+    people.sortBy("/age", SortOrder::DESCENDING);
+    assert(people[0]["name"] == "b" && people[1]["name"] == "c" && people[2]["name"] == "a" && people[3]["name"] == "d");
+
+    people.buildIndex("/name");
+    people.sortBy("/age");
+    assert((people.findByKey("/name", "d") == std::vector<size_t>{0}));
+
+    JSONArray numbers = {3, 1, 2};
+    numbers.sortBy("", SortOrder::DESCENDING);
+    assert(numbers == JSONArray({3, 2, 1}) && numbers.isPacked());
+
+    bool threw = false;
+    try { JSONArray({JSONObject{{"k", 1}}, JSONObject{{"k", "str"}}}).sortBy("/k"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    threw = false;
+    try { JSONArray({JSONObject{{"k", 1}}, JSONObject{}}).sortBy("/k"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    // large enough to be merge sorted in parallel runs
+    JSONArray big;
+    for (int i = 0; i < 100000; ++i) {
+        big.append(JSONObject{{"key", (i * 7919) % 1000}, {"position", i}});
+    }
+    big.sortBy("/key", SortOrder::ASCENDING, 4);
+    for (size_t i = 1; i < big.size(); ++i) {
+        const JSONObject& prev = big[i - 1];
+        const JSONObject& curr = big[i];
+        assert(prev["key"] < curr["key"] || (prev["key"] == curr["key"] && prev["position"] < curr["position"]));
+    }
+}
+
+static constexpr auto staticConfig = SIMPLEJSON_STATIC_JSON(R"({"name": "server", "port": 8080, "ratio": 0.25, "debug": false, "tags": ["a", "b\n"], "limits": {"min": -9223372036854775808, "none": null}})");
+
+void testStaticJSON() {
+    using namespace simpleJSON;
+    using namespace simpleJSON::literals;
+
+    static_assert(staticConfig.root().isMap() && staticConfig.root().getNumberOfFields() == 6);
+    static_assert(staticConfig.root()["name"].getString() == "server");
+    static_assert(staticConfig.root()["port"].getIntegral() == 8080);
+    static_assert(!staticConfig.root()["debug"].getBoolean());
+    static_assert(staticConfig.root()["tags"].size() == 2 && staticConfig.root()["tags"][1].getString() == "b\\n");
+    static_assert(staticConfig.root()["limits"]["min"].getIntegral() == std::numeric_limits<JSONIntegral>::min());
+    static_assert(staticConfig.root()["limits"]["none"].isNull());
+    static_assert(!staticConfig.root().hasField("missing"));
+
+    assert(equals(staticConfig.root()["ratio"].getNumber().getFloating(), 0.25));
+
+    auto runtime = R"({"name": "server", "port": 8080, "ratio": 0.25, "debug": false, "tags": ["a", "b\n"], "limits": {"min": -9223372036854775808, "none": null}})"_json;
+    assert(staticConfig.root().toJSONObject() == runtime);
+
+    bool threw = false;
+    try { staticConfig.root()["missing"]; } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    threw = false;
+    try { staticConfig.root()["ratio"].getIntegral(); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+}
+
+void testPrettyPrintOptions() {
+    using namespace simpleJSON;
+
+    JSONObject obj = {
+        {"numbers", JSONArray{1, 2, 3}},
+        {"mixed", JSONArray{"a", true, nullptr}},
+        {"nested", JSONArray{JSONArray{1}, 2}},
+        {"long", JSONArray{1, 2, 3, 4}},
+        {"empty", JSONArray{}},
+        {"map", {{"k", "v"}}}
+    };
+
+    PrettyPrintOptions options;
+    options.indentString = "  ";
+    options.keySeparator = ": ";
+    options.compactArrayLimit = 3;
+
+    std::string expected =
+        "{\n"
+        "  \"empty\": [],\n"
+        "  \"long\": [\n    1,\n    2,\n    3,\n    4\n  ],\n"
+        "  \"map\": {\n    \"k\": \"v\"\n  },\n"
+        "  \"mixed\": [\"a\", true, null],\n"
+        "  \"nested\": [\n    [1],\n    2\n  ],\n"
+        "  \"numbers\": [1, 2, 3]\n"
+        "}";
+    assert(dumpToPrettyString(obj, options) == expected);
+    assert(parseFromString(dumpToPrettyString(obj, options)) == obj);
+
+    PrettyPrintOptions defaults;
+    assert(dumpToPrettyString(obj, defaults) == dumpToPrettyString(obj));
+
+#ifndef __SANITIZE_THREAD__
+    // deep documents are built, printed and destroyed without recursion, at a depth that overflows any recursive
+    // printer. ThreadSanitizer makes a million levels too slow.
+    const size_t depth = 1000000;
+    JSONObject deep = JSONArray{};
+    for (size_t i = 1; i < depth; ++i) {
+        JSONObject wrapper = JSONArray{};
+        wrapper.append(std::move(deep));
+        deep = std::move(wrapper);
+    }
+    std::string deepExpected;
+    for (size_t i = 1; i < depth; ++i) {
+        deepExpected += "[\n";
+    }
+    deepExpected += "[]";
+    for (size_t i = 1; i < depth; ++i) {
+        deepExpected += "\n]";
+    }
+    assert(dumpToPrettyString(deep, "") == deepExpected);
+
+    JSONObject deepMap;
+    for (size_t i = 1; i < depth; ++i) {
+        JSONObject wrapper;
+        wrapper["k"] = std::move(deepMap);
+        deepMap = std::move(wrapper);
+    }
+#endif
+}
+
+void testMeasure() {
+    using namespace simpleJSON;
+
+    JSONObject obj = {
+        {"numbers", JSONArray{1, -25, 3.75, 1e300}},
+        {"strings", JSONArray{"", "a\\\"b", "\\u00e9"}},
+        {"literals", JSONArray{true, false, nullptr}},
+        {"empty", {{"array", JSONArray{}}, {"object", JSONObject{}}}}
+    };
+    obj["events"] = parseFromFile("testInputs/mediumJson.json");
+
+    assert(measure(obj) == dumpToString(obj).size());
+    assert(measure(JSONObject{}) == 2 && measure(42) == 2 && measure("abc") == 5);
+
+    PrettyPrintOptions options;
+    assert(measure(obj, options) == dumpToPrettyString(obj).size());
+
+    options.indentString = "   ";
+    options.keySeparator = ":";
+    options.compactArrayLimit = 4;
+    assert(measure(obj, options) == dumpToPrettyString(obj, options).size());
+}
+
+void testCanonicalJSON() {
+    using namespace simpleJSON;
+
+    // RFC 8785 section 3.2.2
+    std::string input = R"({
+        "numbers": [333333333.33333329, 1E30, 4.50, 2e-3, 0.000000000000000000000000001],
+        "string": "\u20ac$\u000F\u000aA'\u0042\u0022\u005c\\\"\/",
+        "literals": [null, true, false]
+    })";
+    std::string expected = "{\"literals\":[null,true,false],\"numbers\":[333333333.3333333,1e+30,4.5,0.002,1e-27],"
+                           "\"string\":\"\xe2\x82\xac$\\u000f\\nA'B\\\"\\\\\\\\\\\"/\"}";
+    assert(dumpToCanonicalString(parseFromString(input)) == expected);
+
+    // RFC 8785 section 3.2.3, keys are sorted by UTF-16 code units
+    std::string keys = R"({"€": "Euro Sign", "\r": "Carriage Return", "דּ": "Hebrew Letter Dalet With Dagesh",
+                           "1": "One", "😀": "Emoji: Grinning Face", "\u0080": "Control", "ö": "Latin Small Letter O With Diaeresis"})";
+    std::string canonical = dumpToCanonicalString(parseFromString(keys));
+    size_t position = 0;
+    for (const char* value : {"Carriage Return", "One", "Control", "Latin Small", "Euro Sign", "Emoji", "Hebrew"}) {
+        size_t found = canonical.find(value);
+        assert(found != std::string::npos && found > position);
+        position = found;
+    }
+
+    // RFC 8785 appendix B
+    std::vector<std::pair<double, std::string>> numbers = {
+        {0.0, "0"}, {-0.0, "0"}, {5e-324, "5e-324"}, {-5e-324, "-5e-324"},
+        {1.7976931348623157e308, "1.7976931348623157e+308"}, {9007199254740992.0, "9007199254740992"},
+        {-9007199254740992.0, "-9007199254740992"}, {295147905179352830000.0, "295147905179352830000"},
+        {1e21, "1e+21"}, {999999999999999900000.0, "999999999999999900000"}, {0.000001, "0.000001"},
+        {1e-7, "1e-7"}, {1.5, "1.5"}, {-123.25, "-123.25"}, {0.00000125, "0.00000125"}
+    };
+    for (auto& [number, spelling] : numbers) {
+        assert(dumpToCanonicalString(JSONArray{number}) == "[" + spelling + "]");
+    }
+    assert(dumpToCanonicalString(JSONObject{{"n", 42}}) == "{\"n\":42}");
+
+    bool threw = false;
+    try { dumpToCanonicalString(JSONArray{std::numeric_limits<double>::infinity()}); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    // numbers are written as the double nearest to the stored value, ties to even
+    assert(dumpToCanonicalString(JSONArray{JSONIntegral(9007199254740993LL), JSONIntegral(-9007199254740995LL), JSONIntegral(9007199254740997LL)})
+           == "[9007199254740992,-9007199254740996,9007199254740996]");
+    if constexpr (std::numeric_limits<JSONFloating>::digits > std::numeric_limits<double>::digits) {
+        assert(dumpToCanonicalString(JSONArray{JSONFloating(9007199254740993.0L), JSONFloating(9007199254740993.5L), JSONFloating(-9007199254740995.0L)})
+               == "[9007199254740992,9007199254740994,-9007199254740996]");
+    }
+
+    // parsing is not changed for canonical output: a long double that lands on a midpoint between doubles
+    // rounds to even when written, a double is already the nearest one to the input
+    const bool wideFloating = std::numeric_limits<JSONFloating>::digits > std::numeric_limits<double>::digits;
+    assert(dumpToCanonicalString(parseFromString("[9007199254740993.0000000001]")) == (wideFloating ? "[9007199254740992]" : "[9007199254740994]"));
+
+    // the same member spelled twice
+    threw = false;
+    try { dumpToCanonicalString(parseFromString(R"({"a": 1, "\u0061": 2})")); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    // FIPS 180-4 test vectors
+    SHA256 hash;
+    assert(SHA256::toHex(hash.finish()) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    hash.reset();
+    hash.update("abc");
+    assert(SHA256::toHex(hash.finish()) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    hash.reset();
+    std::string million(1000000, 'a');
+    for (size_t i = 0; i < million.size(); i += 999) {
+        hash.update(std::string_view(million).substr(i, 999));
+    }
+    assert(SHA256::toHex(hash.finish()) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+    auto events = parseFromFile("testInputs/mediumJson.json");
+    std::string eventsCanonical = dumpToCanonicalString(events);
+    assert(parseFromString(eventsCanonical) == parseFromString(dumpToCanonicalString(parseFromString(eventsCanonical))));
+    hash.reset();
+    hash.update(eventsCanonical);
+    assert(canonicalSHA256(events) == hash.finish());
+}
+
 void testJSONObject() {
     using namespace simpleJSON;
 
@@ -298,6 +847,820 @@ void testJSONObject() {
     assert(obj["numberField"] > obj11);
 }
 
+void testJSONKey() {
+    using namespace simpleJSON;
+    using namespace simpleJSON::literals;
+
+    constexpr JSONKey login = "login"_k;
+    static_assert(login.name.size() == 5 && login.hash == JSONKey(std::string_view("login")).hash);
+    static_assert("login"_k == login && "id"_k != login);
+
+    JSONObject obj = {{"actor", {{"login", "someone"}, {"id", 7}}}};
+    assert(obj["actor"_k][login] == "someone");
+    assert(obj["actor"_k]["id"_k] == 7);
+
+    const JSONObject& constObj = obj;
+    assert(constObj["actor"_k]["id"_k] == obj["actor"]["id"]);
+    bool threw = false;
+    try { constObj["missing"_k]; } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    obj["added"_k] = "value";
+    assert(obj.getNumberOfFields() == 2 && obj["added"] == "value");
+    obj["added"_k] = 1;
+    assert(obj.getNumberOfFields() == 2 && obj["added"] == 1);
+    assert(obj.asMap().count(std::string_view("added")) == 1);
+}
+
+void testConcurrentReads() {
+    using namespace simpleJSON;
+    using namespace simpleJSON::literals;
+
+    JSONObject config = {{"name", "server"}, {"ports", {}}, {"nested", {{"ratio", 0.5}}}};
+    config["ports"] = JSONArray();
+    for (int i = 0; i < 100; ++i) {
+        config["ports"].append(8000 + i);
+    }
+    assert(config["ports"].asArray().isPacked());
+
+    const JSONObject& constConfig = config;
+    assert(constConfig.find("name") != nullptr && *constConfig.find("name") == "server");
+    assert(constConfig.find("missing") == nullptr && constConfig.find("missing"_k) == nullptr);
+    assert(constConfig.getNumberOfFields() == 3);
+
+    size_t fieldCount = 0;
+    constConfig.forEachField([&](const JSONString& key, const JSONObject& val) {
+        assert(constConfig.find(key.getString()) == &val);
+        ++fieldCount;
+    });
+    assert(fieldCount == 3);
+
+    // const access never unpacks, references to packed elements point into a cache of the array
+    assert(constConfig["ports"].get(3) == 8003 && constConfig["ports"].asArray().get(99) == 8099);
+    assert(constConfig["ports"].asArray().isPacked());
+    assert(constConfig["ports"][0] == 8000 && &constConfig["ports"][0] == &constConfig["ports"][0]);
+    assert(*JSONPointer("/ports/1").resolve(constConfig) == 8001);
+    JSONObject scratch;
+    assert(JSONPointer("/ports/1").resolve(constConfig, scratch) == &scratch && scratch == 8001);
+    assert(constConfig["ports"].asArray().isPacked());
+
+    // parsed numeric arrays are packed and readable through a const reference
+    const JSONObject parsed = parseFromString("{\"xs\": [1, 2, 3], \"fs\": [0.5, 1.5]}");
+    assert(parsed["xs"].asArray().isPacked() && parsed["fs"].asArray().isPacked());
+    assert(parsed["xs"][0] == 1 && parsed["xs"][2] == 3 && parsed["fs"][1] == 1.5);
+    assert(*JSONPointer("/xs/1").resolve(parsed) == 2);
+
+    // changes drop the cache, copies do not share it
+    JSONObject growing = parsed;
+    assert(static_cast<const JSONObject&>(growing)["xs"][2] == 3);
+    growing["xs"].append(4);
+    growing["xs"].asArray().pop();
+    growing["xs"].append(5);
+    assert(growing["xs"].asArray().isPacked() && static_cast<const JSONObject&>(growing)["xs"][3] == 5);
+    JSONArray copied = growing["xs"].asArray();
+    assert(static_cast<const JSONArray&>(copied)[3] == 5 && &static_cast<const JSONArray&>(copied)[3] != &static_cast<const JSONObject&>(growing)["xs"][3]);
+
+    JSONObject unpacked = config;
+    unpacked["ports"].asArray().unpack();
+    assert(!unpacked["ports"].asArray().isPacked() && unpacked == config);
+    assert(static_cast<const JSONObject&>(unpacked)["ports"][2] == 8002);
+
+    // frozen documents have their arrays unpacked up front, shared ones build element caches while being read
+    std::shared_ptr<const JSONObject> frozen = freeze(config);
+    std::shared_ptr<const JSONObject> shared = std::make_shared<const JSONObject>(config);
+    std::shared_ptr<const JSONObject> document = freeze(parseFromFile("testInputs/mediumJson.json"));
+    assert(!(*frozen)["ports"].asArray().isPacked() && *frozen == config);
+    const std::string expectedDump = dumpToString(*document);
+
+    std::vector<std::thread> readers;
+    std::atomic<size_t> mismatches = 0;
+
+    for (int t = 0; t < 8; ++t) {
+        readers.emplace_back([&, t]() {
+            for (int iteration = 0; iteration < 20; ++iteration) {
+                const JSONObject& doc = *document;
+                for (size_t i = t % 2; i < doc.size(); i += 2) {
+                    const JSONObject* actor = doc[i].find("actor");
+                    if (actor == nullptr || actor->find("login"_k) == nullptr || doc[i].find("no such key") != nullptr) {
+                        ++mismatches;
+                    }
+                }
+
+                if ((*frozen)["ports"][size_t(iteration)] != 8000 + iteration || (*frozen)["nested"_k]["ratio"] != 0.5
+                    || (*shared)["ports"].get(size_t(iteration)) != 8000 + iteration || (*shared)["ports"][size_t(iteration)] != 8000 + iteration) {
+                    ++mismatches;
+                }
+            }
+
+            if (dumpToString(*document) != expectedDump) {
+                ++mismatches;
+            }
+        });
+    }
+
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    assert(mismatches == 0);
+    assert(dumpToString(*document) == expectedDump);
+    assert((*shared)["ports"].asArray().isPacked());
+}
+
+void testSharedDocument() {
+    using namespace simpleJSON;
+    using namespace simpleJSON::literals;
+
+    SharedDocument shared(JSONObject{{"version", 0}, {"items", JSONArray()}});
+    std::shared_ptr<const JSONObject> first = shared.load();
+    assert((*first)["version"] == 0);
+
+    std::atomic<bool> done = false;
+    std::atomic<size_t> inconsistent = 0;
+    std::vector<std::thread> readers;
+
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                std::shared_ptr<const JSONObject> doc = shared.load();
+                // every published version holds as many items as its version number
+                if ((*doc)["items"].size() != size_t((*doc)["version"].asNumber().getIntegral())) {
+                    ++inconsistent;
+                }
+            }
+        });
+    }
+
+    for (int version = 1; version <= 50; ++version) {
+        shared.update([&](JSONObject& doc) {
+            doc["version"_k] = version;
+            doc["items"_k].append(version);
+        });
+    }
+
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    assert(inconsistent == 0);
+    assert((*shared.load())["version"] == 50 && (*shared.load())["items"].size() == 50);
+    // readers keep the version they loaded
+    assert((*first)["version"] == 0 && (*first)["items"].size() == 0);
+
+    shared.reloadFromFile("testInputs/mediumJson.json");
+    assert(*shared.load() == parseFromFile("testInputs/mediumJson.json"));
+
+    std::shared_ptr<const JSONObject> beforeFailedReload = shared.load();
+    bool threw = false;
+    try { shared.reloadFromFile("testInputs/doesNotExist.json"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+    assert(shared.load() == beforeFailedReload);
+
+    shared.store(JSONObject{{"replaced", true}});
+    assert((*shared.load())["replaced"] == true);
+}
+
+void testParseBatch() {
+    using namespace simpleJSON;
+
+    auto events = parseFromFile("testInputs/mediumJson.json");
+    std::vector<std::string> texts;
+    for (size_t i = 0; i < events.size(); ++i) {
+        texts.push_back(dumpToString(events[i]));
+    }
+    texts.push_back("{\"unterminated\": [1, 2");
+    texts.push_back("[1, 2] trailing");
+    texts.push_back("  42  ");
+
+    std::vector<std::string_view> documents(texts.begin(), texts.end());
+
+    for (size_t threads : {1, 4}) {
+        std::vector<BatchParseResult> results = parseBatch(documents, threads);
+        assert(results.size() == documents.size());
+
+        for (size_t i = 0; i < events.size(); ++i) {
+            assert(results[i].success && results[i].error.empty());
+            assert(results[i].value == events[i]);
+        }
+
+        size_t invalid = events.size();
+        assert(!results[invalid].success && !results[invalid + 1].success);
+        assert(results[invalid + 1].error.find("Expected EOF") != std::string::npos);
+        assert(results[invalid + 2].success && results[invalid + 2].value == 42);
+    }
+
+    assert(parseBatch(nullptr, 0).empty());
+
+    // concurrent batches share the worker threads
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 4; ++i) {
+        callers.emplace_back([&]() {
+            std::vector<BatchParseResult> results = parseBatch(documents, 4);
+            assert(results[0].value == events[0] && results[events.size() + 2].value == 42);
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+#ifdef __linux__
+    // worker threads are started once and reused by later calls
+    auto threadsInProcess = []() {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("Threads:", 0) == 0) {
+                return std::stoul(line.substr(8));
+            }
+        }
+        return 0ul;
+    };
+
+    unsigned long threadsBefore = threadsInProcess();
+    assert(threadsBefore >= 4);
+    for (int i = 0; i < 20; ++i) {
+        parseBatch(documents, 4);
+    }
+    assert(threadsInProcess() == threadsBefore);
+#endif
+}
+
+void testParseFiles() {
+    using namespace simpleJSON;
+
+    {
+        std::ofstream invalid("test.txt");
+        invalid << "{\"key\": [1, 2";
+    }
+
+    std::vector<std::string> fileNames;
+    for (int i = 0; i < 40; ++i) {
+        fileNames.push_back("testInputs/smallJson.json");
+    }
+    fileNames.push_back("testInputs/mediumJson.json");
+    fileNames.push_back("testInputs/doesNotExist.json");
+    fileNames.push_back("test.txt");
+
+    auto small = parseFromFile("testInputs/smallJson.json");
+    auto medium = parseFromFile("testInputs/mediumJson.json");
+
+    for (FileReadBackend backend : {FileReadBackend::AUTO, FileReadBackend::THREAD_POOL}) {
+        for (size_t queueDepth : {1, 8, 64}) {
+            std::vector<BatchParseResult> results = parseFiles(fileNames, 2, queueDepth, backend);
+            assert(results.size() == fileNames.size());
+
+            for (size_t i = 0; i < 40; ++i) {
+                assert(results[i].success && results[i].value == small);
+            }
+            assert(results[40].success && results[40].value == medium);
+            assert(!results[41].success && results[41].error == "Could not open file");
+            assert(!results[42].success && !results[42].error.empty());
+        }
+    }
+
+    assert(parseFiles({}).empty());
+    std::remove("test.txt");
+}
+
+void testParallelDump() {
+    using namespace simpleJSON;
+
+    auto events = parseFromFile("testInputs/mediumJson.json");
+
+    JSONObject wide;
+    JSONArray packed;
+    JSONArray records;
+    for (int i = 0; i < 5000; ++i) {
+        packed.append(i * 3);
+        records.append(JSONObject{{"id", i}, {"tags", JSONArray()}, {"name", "record " + std::to_string(i)}});
+        wide["key" + std::to_string(i)] = i % 7 == 0 ? JSONObject(JSONArray()) : JSONObject(i * 0.5);
+    }
+
+    JSONObject nested = {{"packed", packed}, {"records", records}, {"wide", wide}, {"events", events}, {"empty", JSONObject()}};
+
+    for (const JSONObject* doc : {&events, &wide, &nested}) {
+        std::string compact = dumpToString(*doc);
+        std::string pretty = dumpToPrettyString(*doc);
+        std::string prettySpaces = dumpToPrettyString(*doc, "  ");
+
+        for (size_t threads : {1, 3}) {
+            assert(dumpToStringParallel(*doc, threads) == compact);
+            assert(dumpToPrettyStringParallel(*doc, defaultIndentString, threads) == pretty);
+            assert(dumpToPrettyStringParallel(*doc, "  ", threads) == prettySpaces);
+        }
+    }
+
+    assert(dumpToStringParallel(JSONObject(JSONArray())) == "[]");
+    assert(dumpToPrettyStringParallel(JSONObject()) == "{}");
+    assert(dumpToStringParallel(JSONObject("text")) == "\"text\"");
+    assert(packed.isPacked());
+}
+
+void testParallelCompare() {
+    using namespace simpleJSON;
+
+    auto events = parseFromFile("testInputs/mediumJson.json");
+
+    JSONObject records;
+    for (int i = 0; i < 3000; ++i) {
+        records["r" + std::to_string(i)] = JSONObject{{"id", i}, {"values", JSONArray()}};
+        records["r" + std::to_string(i)]["values"].append(i);
+        records["r" + std::to_string(i)]["values"].append(i + 1);
+    }
+
+    JSONObject lhs = {{"events", events}, {"records", records}};
+    JSONObject rhs = lhs;
+
+    for (size_t threads : {1, 3}) {
+        assert(equalsParallel(lhs, rhs, threads));
+        assert(structuralHash(lhs, threads) == structuralHash(rhs, 1));
+        assert(diff(lhs, rhs, threads).empty());
+    }
+
+    // packed and unpacked arrays with the same elements are equal and hash the same
+    JSONArray packed;
+    packed.append(1);
+    packed.append(2);
+    JSONArray unpacked = packed;
+    unpacked[0];
+    assert(packed.isPacked() && !unpacked.isPacked());
+    assert(equalsParallel(JSONObject(packed), JSONObject(unpacked)));
+    assert(structuralHash(JSONObject(packed)) == structuralHash(JSONObject(unpacked)));
+    assert(structuralHash(JSONObject(1)) != structuralHash(JSONObject(1.0)));
+    assert(structuralHash(JSONObject("1")) != structuralHash(JSONObject(1)));
+
+    rhs["records"]["r2500"]["values"][1] = "changed";
+    rhs["records"].removeField("r10");
+    rhs["records"]["r~/new"] = true;
+    rhs["events"][0]["actor"]["login"] = "someone else";
+    rhs["events"].append(nullptr);
+
+    for (size_t threads : {1, 3}) {
+        assert(!equalsParallel(lhs, rhs, threads));
+        assert(structuralHash(lhs, threads) != structuralHash(rhs, threads));
+
+        std::vector<JSONDifference> differences = diff(lhs, rhs, threads);
+        assert(differences.size() == 5);
+        assert(differences[0].kind == DifferenceKind::CHANGED && differences[0].path.toString() == "/events/0/actor/login");
+        assert(differences[1].kind == DifferenceKind::ADDED && differences[1].path == JSONPointer("/events/" + std::to_string(events.size())));
+        assert(differences[2].kind == DifferenceKind::REMOVED && differences[2].path.toString() == "/records/r10");
+        assert(differences[3].kind == DifferenceKind::CHANGED && differences[3].path.toString() == "/records/r2500/values/1");
+        assert(differences[4].kind == DifferenceKind::ADDED && differences[4].path.toString() == "/records/r~0~1new");
+        assert(differences[4].path.resolve(rhs) != nullptr && *differences[4].path.resolve(rhs) == true);
+    }
+
+    // a large container inside a split parent is split again
+    JSONObject nested = records;
+    nested["big"] = JSONArray();
+    for (int i = 0; i < 5000; ++i) {
+        nested["big"].append(JSONObject{{"n", i}});
+    }
+    JSONObject nestedChanged = nested;
+    nestedChanged["big"][4321]["n"] = -1;
+    nestedChanged["r5"]["id"] = -5;
+
+    for (size_t threads : {1, 3}) {
+        assert(equalsParallel(nested, JSONObject(nested), threads));
+        assert(!equalsParallel(nested, nestedChanged, threads));
+        assert(structuralHash(nested, threads) == structuralHash(nested, 1));
+        assert(structuralHash(nestedChanged, threads) != structuralHash(nested, threads));
+
+        std::vector<JSONDifference> differences = diff(nested, nestedChanged, threads);
+        assert(differences.size() == 2);
+        assert(differences[0].path.toString() == "/big/4321/n");
+        assert(differences[1].path.toString() == "/r5/id");
+    }
+
+    JSONObject changedType = lhs;
+    changedType["records"] = JSONArray();
+    assert(!equalsParallel(lhs, changedType));
+    std::vector<JSONDifference> typeDifference = diff(lhs, changedType);
+    assert(typeDifference.size() == 1 && typeDifference[0].path.toString() == "/records");
+}
+
+#ifdef SIMPLEJSON_HAS_COROUTINES
+// In-memory async byte source, every next() suspends and is resumed by the test's event loop
+struct TestAsyncSource {
+    std::string_view data;
+    size_t chunkSize;
+    size_t pos = 0;
+    std::vector<std::coroutine_handle<>>* readyQueue;
+
+    struct NextChunk {
+        TestAsyncSource* source;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { source->readyQueue->push_back(handle); }
+        std::optional<std::string_view> await_resume() {
+            if (source->pos >= source->data.size()) {
+                return std::nullopt;
+            }
+            std::string_view chunk = source->data.substr(source->pos, source->chunkSize);
+            source->pos += chunk.size();
+            return chunk;
+        }
+    };
+
+    NextChunk next() { return NextChunk{this}; }
+};
+
+struct TestDriver {
+    struct promise_type {
+        TestDriver get_return_object() { return TestDriver{}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+TestDriver parseWithCoroutine(simpleJSON::JSONStreamParser& parser, TestAsyncSource& source, simpleJSON::JSONObject& out, bool& done) {
+    out = co_await parser.parse(source);
+    done = true;
+}
+#endif
+
+void testStreamParser() {
+    using namespace simpleJSON;
+
+    std::ifstream file("testInputs/mediumJson.json");
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+    auto expected = parseFromString(text);
+
+    for (size_t chunkSize : {size_t(1), size_t(7), size_t(4096), text.size()}) {
+        JSONStreamParser parser;
+        for (size_t pos = 0; pos < text.size(); pos += chunkSize) {
+            parser.feed(std::string_view(text).substr(pos, chunkSize));
+        }
+        assert(parser.finish() == expected);
+    }
+
+    std::vector<std::pair<JSONTokenType, std::string>> tokens;
+    JSONTokenizer tokenizer;
+    auto collect = [&](const JSONToken& token) { tokens.emplace_back(token.type, std::string(token.text)); };
+    std::string small = "{\"a\\\"b\": [1.5e3, -2, true, null, \"x\"], \"c\": {}}";
+    for (char c : small) {
+        tokenizer.feed(std::string_view(&c, 1), collect);
+    }
+    assert(tokenizer.isComplete());
+    tokenizer.finish(collect);
+
+    std::vector<std::pair<JSONTokenType, std::string>> expectedTokens = {
+        {JSONTokenType::BEGIN_OBJECT, "{"}, {JSONTokenType::KEY, "a\\\"b"}, {JSONTokenType::BEGIN_ARRAY, "["}, 
+        {JSONTokenType::NUMBER, "1.5e3"}, {JSONTokenType::NUMBER, "-2"}, {JSONTokenType::BOOL, "true"}, {JSONTokenType::NULL_VALUE, "null"}, 
+        {JSONTokenType::STRING, "x"}, {JSONTokenType::END_ARRAY, "]"}, {JSONTokenType::KEY, "c"}, {JSONTokenType::BEGIN_OBJECT, "{"}, 
+        {JSONTokenType::END_OBJECT, "}"}, {JSONTokenType::END_OBJECT, "}"}
+    };
+    assert(tokens == expectedTokens);
+
+    JSONStreamParser scalarParser;
+    scalarParser.feed("  12");
+    scalarParser.feed("34 ");
+    assert(scalarParser.finish() == 1234);
+
+    for (const char* invalid : {"[1, 2", "{\"a\" 1}", "[1,]", "[01]", "\"abc", "[tru]", "{} {}", "", "[\"\\x\"]", "{\"a\": 1,}"}) {
+        bool threw = false;
+        try {
+            JSONStreamParser parser;
+            parser.feed(invalid);
+            parser.finish();
+        }
+        catch (const JSONException&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+#ifdef SIMPLEJSON_HAS_COROUTINES
+    std::vector<std::coroutine_handle<>> readyQueue;
+    TestAsyncSource source{text, 1000, 0, &readyQueue};
+    JSONStreamParser parser;
+    JSONObject result;
+    bool done = false;
+
+    parseWithCoroutine(parser, source, result, done);
+
+    // the event loop keeps running between chunks
+    size_t iterations = 0;
+    while (!readyQueue.empty()) {
+        auto handle = readyQueue.back();
+        readyQueue.pop_back();
+        ++iterations;
+        handle.resume();
+    }
+
+    assert(done && result == expected);
+    assert(iterations > text.size() / 1000);
+#endif
+}
+
+void testPipelinedLoading() {
+    using namespace simpleJSON;
+
+    auto expected = parseFromFile("testInputs/mediumJson.json");
+
+    assert(parseFromFilePipelined("testInputs/mediumJson.json") == expected);
+    assert(parseFromFilePipelined("testInputs/mediumJson.json", 4096, 2) == expected);
+    assert(parseFromFilePipelined("testInputs/smallJson.json", 3, 1) == parseFromFile("testInputs/smallJson.json"));
+
+    size_t recordCount = 0;
+    bool inOrder = true;
+    forEachRecordInFile("testInputs/mediumJson.json", [&](JSONObject& record) {
+        inOrder = inOrder && record == expected[recordCount];
+        ++recordCount;
+    }, 1000, 3);
+    assert(inOrder && recordCount == expected.size());
+
+    bool threw = false;
+    try { parseFromFilePipelined("testInputs/doesNotExist.json"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    threw = false;
+    size_t processed = 0;
+    try {
+        forEachRecordInFile("testInputs/mediumJson.json", [&](JSONObject&) {
+            if (++processed == 10) {
+                throw std::runtime_error("stop");
+            }
+        }, 512);
+    }
+    catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && processed == 10);
+}
+
+void testJSONWriter() {
+    using namespace simpleJSON;
+
+    JSONObject expected = {
+        {"a", JSONArray{1, 2.5, "x", true, nullptr, JSONArray{}, JSONObject{}}},
+        {"b", {{"c", "d"}, {"e", JSONArray{JSONArray{3}}}}},
+        {"f", JSONObject{}}
+    };
+
+    auto writeExpected = [](JSONWriter& writer) {
+        writer.startObject()
+                .key("a").startArray()
+                    .value(1).value(2.5).value("x").value(true).value(nullptr).startArray().endArray().startObject().endObject()
+                .endArray()
+                .key("b").startObject()
+                    .key("c").value(std::string("d"))
+                    .key("e").startArray().startArray().value(JSONNumber(3)).endArray().endArray()
+                .endObject()
+                .key("f").startObject().endObject()
+            .endObject();
+    };
+
+    for (const std::string& indent : {std::string(""), std::string("  "), defaultIndentString}) {
+        std::string out;
+        JSONWriter writer(out, indent);
+        assert(!writer.isComplete());
+        writeExpected(writer);
+        assert(writer.isComplete());
+        assert(out == (indent.empty() ? dumpToString(expected) : dumpToPrettyString(expected, indent)));
+    }
+
+    auto events = parseFromFile("testInputs/mediumJson.json");
+    {
+        std::ostringstream stream;
+        {
+            JSONWriter writer(stream, defaultIndentString);
+            writer.startArray();
+            for (size_t i = 0; i < events.size(); ++i) {
+                writer.value(events[i]);
+            }
+            writer.endArray();
+        }
+        assert(stream.str() == dumpToPrettyString(events));
+    }
+
+    {
+        std::string out;
+        JSONWriter writer(out);
+        writer.startObject().key("quote\"key").value("line\nbreak\\").endObject();
+        assert(out == "{\"quote\\\"key\":\"line\\nbreak\\\\\"}");
+        assert(parseFromString(out)["quote\\\"key"] == JSONString("line\\nbreak\\\\"));
+    }
+
+#ifdef SIMPLEJSON_HAS_MMAP
+    {
+        int fd = ::open("test.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        assert(fd >= 0);
+        {
+            JSONWriter writer(fd);
+            writer.value(events);
+        }
+        ::close(fd);
+        assert(parseFromFile("test.txt") == events);
+        std::remove("test.txt");
+    }
+#endif
+
+    // stream errors are reported, both when flushing explicitly and when the buffer fills up
+    struct RejectingBuffer : std::streambuf {
+        int overflow(int) override { return traits_type::eof(); }
+        std::streamsize xsputn(const char*, std::streamsize) override { return 0; }
+    };
+    RejectingBuffer rejecting;
+    {
+        std::ostream rejectingStream(&rejecting);
+        JSONWriter writer(rejectingStream);
+        writer.value("small");
+        bool threw = false;
+        try { writer.flush(); } catch (const JSONException&) { threw = true; }
+        assert(threw);
+    }
+    {
+        std::ostream rejectingStream(&rejecting);
+        JSONWriter writer(rejectingStream);
+        bool threw = false;
+        try {
+            writer.startArray();
+            for (int i = 0; i < 100000; ++i) {
+                writer.value(i);
+            }
+        }
+        catch (const JSONException&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+#ifndef NDEBUG
+    auto throwsJSONException = [](auto&& calls) {
+        std::string out;
+        JSONWriter writer(out);
+        try {
+            calls(writer);
+        }
+        catch (const JSONException&) {
+            return true;
+        }
+        return false;
+    };
+
+    assert(throwsJSONException([](JSONWriter& writer) { writer.startObject().value(1); }));
+    assert(throwsJSONException([](JSONWriter& writer) { writer.startObject().key("a").key("b"); }));
+    assert(throwsJSONException([](JSONWriter& writer) { writer.startObject().key("a").endObject(); }));
+    assert(throwsJSONException([](JSONWriter& writer) { writer.startArray().key("a"); }));
+    assert(throwsJSONException([](JSONWriter& writer) { writer.startArray().endObject(); }));
+    assert(throwsJSONException([](JSONWriter& writer) { writer.endArray(); }));
+    assert(throwsJSONException([](JSONWriter& writer) { writer.value(1).value(2); }));
+    assert(!throwsJSONException([](JSONWriter& writer) { writer.startArray().startObject().key("a").value(1).endObject().endArray(); }));
+#endif
+}
+
+void testJSONFilter() {
+    using namespace simpleJSON;
+
+    std::string input = R"({"b": 1.50, "a": "x\u0041", "c": [1, {"d": 2, "e": [true]}, 3], "secret": {"nested": null}})";
+
+    JSONFilter filter;
+    filter.drop("/c/1/d").drop("/secret").redact("/c/*/e").replace("/c/2", JSONObject{{"three", 3}});
+    std::string expected = R"({"b":1.50,"a":"x\u0041","c":[1,{"e":"[REDACTED]"},{"three":3}]})";
+    assert(filter.apply(input) == expected);
+
+    // chunk boundaries do not matter
+    std::string out;
+    {
+        JSONWriter writer(out);
+        filter.reset();
+        for (char c : input) {
+            filter.feed(std::string_view(&c, 1), writer);
+        }
+        filter.finish(writer);
+    }
+    assert(out == expected);
+
+    // pretty output comes from the writer
+    std::string pretty;
+    {
+        JSONWriter writer(pretty, defaultIndentString);
+        filter.reset();
+        filter.feed(R"({"a": [1, 2], "secret": 1})", writer);
+        filter.finish(writer);
+    }
+    assert(pretty == dumpToPrettyString(JSONObject{{"a", JSONArray{1, 2}}}));
+
+    assert(JSONFilter().apply(" [1 , 2.0e5, \"\\\"\"] ") == "[1,2.0e5,\"\\\"\"]");
+    bool threw = false;
+    try { JSONFilter().drop(""); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+    assert(JSONFilter().replace("", nullptr).apply("{\"a\": 1}") == "null");
+    assert(JSONFilter().drop("/0").drop("/2").apply("[0, 1, 2, 3]") == "[1,3]");
+
+    // keys are matched after unescaping, but written as they were spelled
+    assert(JSONFilter().redact("/password").apply(R"({"p\u0061ssword": "hunter2", "user": "x"})") == R"({"p\u0061ssword":"[REDACTED]","user":"x"})");
+    assert(JSONFilter().drop("/a~1b/\"").apply(R"({"a\/b": {"\"": 1, "q": 2}})") == R"({"a\/b":{"q":2}})");
+
+    // same result as editing the parsed document
+    std::ifstream file("testInputs/mediumJson.json");
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    JSONFilter scrubber;
+    scrubber.drop("/*/actor/avatar_url").redact("/*/actor/login", "***").replace("/*/public", false);
+    JSONObject scrubbed = parseFromString(scrubber.apply(contents.str()));
+
+    JSONObject events = parseFromString(contents.str());
+    for (size_t i = 0; i < events.size(); ++i) {
+        events[i]["actor"].removeField("avatar_url");
+        events[i]["actor"]["login"] = "***";
+        events[i]["public"] = false;
+    }
+    assert(scrubbed == events);
+
+    threw = false;
+    try { filter.apply("{\"a\": [1, 2"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+}
+
+void testMinifyPrettify() {
+    using namespace simpleJSON;
+
+    std::string input = "{ \"b\" : 1.0E+2 ,\n\t\"a\" : [ \"\\u0041  keeps   \\\"inner\\\" spaces and a long tail \\\\\" , -0.50 ] , \"c\":{}}";
+    std::string minified = minify(input);
+    assert(minified == "{\"b\":1.0E+2,\"a\":[\"\\u0041  keeps   \\\"inner\\\" spaces and a long tail \\\\\",-0.50],\"c\":{}}");
+    assert(prettify(minified, "  ") == "{\n  \"b\" : 1.0E+2,\n  \"a\" : [\n    \"\\u0041  keeps   \\\"inner\\\" spaces and a long tail \\\\\",\n    -0.50\n  ],\n  \"c\" : {}\n}");
+    assert(minify(prettify(minified)) == minified);
+
+    auto events = parseFromFile("testInputs/mediumJson.json");
+    assert(minify(dumpToPrettyString(events)) == dumpToString(events));
+    assert(prettify(dumpToString(events)) == dumpToPrettyString(events));
+
+    // stream versions read the input in chunks
+    std::ifstream file("testInputs/mediumJson.json");
+    std::ostringstream compact;
+    minify(file, compact);
+    assert(parseFromString(compact.str()) == events);
+
+    std::istringstream compactInput(compact.str());
+    std::ostringstream pretty;
+    prettify(compactInput, pretty, "    ");
+    assert(minify(pretty.str()) == compact.str());
+
+    // in-memory input has its own single pass minifier, it has to reject exactly what the tokenizer rejects
+    for (const char* invalid : {"[1,]", "{\"a\" 1}", "[\"unterminated", "", "[1] 2", " ", "{,}", "[01]", "[1.]", "[.5]", "[1.2.3]", "[-]", 
+                                "[tru]", "[truex]", "[nul1]", "{\"a\":1,}", "{1:2}", "[\"\\x\"]", "[\"\\u12G4\"]", "[\"tab\tinside\"]", "[}", "{]", "]", "{\"a\"::1}"}) {
+        bool threw = false;
+        try { minify(invalid); } catch (const JSONException&) { threw = true; }
+        assert(threw);
+
+        threw = false;
+        std::istringstream invalidInput(invalid);
+        std::ostringstream ignored;
+        try { minify(invalidInput, ignored); } catch (const JSONException&) { threw = true; }
+        assert(threw);
+
+        // the same kind at the same byte, however the input is chunked
+        JSONSyntaxErrorKind inMemoryKind{};
+        size_t inMemoryOffset = 0;
+        threw = false;
+        try { minify(invalid); } catch (const JSONSyntaxError& e) { inMemoryKind = e.getKind(); inMemoryOffset = e.getOffset(); threw = true; }
+        assert(threw);
+
+        JSONTokenizer tokenizer;
+        std::string_view bytes(invalid);
+        threw = false;
+        try {
+            for (size_t i = 0; i < bytes.size(); ++i) {
+                tokenizer.feed(bytes.substr(i, 1), [](const JSONToken&) {});
+            }
+            tokenizer.finish([](const JSONToken&) {});
+        }
+        catch (const JSONSyntaxError& e) {
+            assert(e.getKind() == inMemoryKind);
+            assert(e.getOffset() == inMemoryOffset);
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // the runtime parsers reuse the static JSON grammar but report their own prefix
+    std::string message;
+    try { minify("[\"\\x\"]"); } catch (const JSONException& e) { message = e.what(); }
+    assert(message == "Error while parsing JSON, invalid escape sequence (at byte 3)");
+
+    message.clear();
+    try { StaticJSON<2>("[\"\\x\"]"); } catch (const JSONException& e) { message = e.what(); }
+    assert(message == "Error while parsing static JSON, invalid escape sequence (at byte 3)");
+
+    message.clear();
+    try { minify("{\"a\" 1}"); } catch (const JSONException& e) { message = e.what(); }
+    assert(message == "Error while parsing JSON, expected ':' (at byte 5)");
+
+    for (const char* valid : {"0", " -0.5e+10 ", "\"\\u00e9\\\"\"", "[true,false,null]", "{\"\":{}}", "[[[]],[{}]]", " {\n\"k\" : \"v with  spaces\" } "}) {
+        std::istringstream validInput(valid);
+        std::ostringstream streamed;
+        minify(validInput, streamed);
+        assert(minify(valid) == streamed.str());
+    }
+}
+
 void testStreamIO() {
     auto obj1 = simpleJSON::parseFromFile("testInputs/smallJson.json");
     std::string obj1Str = simpleJSON::dumpToString(obj1);
@@ -327,15 +1690,236 @@ void testStreamIO() {
     assert(obj3_1 == obj3_2);
 }
 
+void testSnapshot() {
+    using namespace simpleJSON;
+
+    JSONObject obj{
+            {"name", "snapshot"},
+            {"count", 3},
+            {"ratio", -0.25},
+            {"enabled", true},
+            {"missing", JSONNull{}},
+            {"items", JSONArray{1, "two", JSONArray{}, JSONObject{{"k", false}}}},
+            {"empty", JSONObject{}}
+        };
+
+    JSONSnapshot inMemory(dumpToSnapshotString(obj));
+    JSONSnapshotView root = inMemory.root();
+    assert(root.isMap() && root.getNumberOfFields() == 7);
+    assert(root["name"].getString() == "snapshot");
+    assert(root["count"].getNumber() == 3);
+    assert(equals(root["ratio"].getNumber().getFloating(), -0.25));
+    assert(root["enabled"].getBoolean() == true);
+    assert(root["missing"].isNull());
+    assert(root["items"].size() == 4);
+    assert(root["items"][1].getString() == "two");
+    assert(root["items"][3]["k"].getBoolean() == false);
+    assert(root.hasField("empty") && !root.hasField("nonExistantField"));
+    assert(root.toJSONObject() == obj);
+
+    bool threw = false;
+    try { root["nonExistantField"]; } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    auto obj2 = parseFromFile("testInputs/mediumJson.json");
+    saveSnapshot(obj2, "test.snapshot");
+    {
+        JSONSnapshot mapped("test.snapshot");
+        assert(mapped.root().toJSONObject() == obj2);
+    }
+    std::remove("test.snapshot");
+}
+
+void testBinaryCodecs() {
+    using namespace simpleJSON;
+
+    JSONObject hello{{"hello", "world"}};
+    assert(dumpToBSON(hello) == std::string("\x16\x00\x00\x00\x02hello\x00\x06\x00\x00\x00world\x00\x00", 22));
+    assert(parseFromBSON(dumpToBSON(hello)) == hello);
+
+    JSONObject obj{
+            {"str", "quote \\\" backslash \\\\ newline \\n"},
+            {"small", 3},
+            {"big", 12345678901LL},
+            {"ratio", -0.5},
+            {"flag", false},
+            {"nothing", nullptr},
+            {"ints", JSONArray{1, -2, 300}},
+            {"floats", JSONArray{0.5, 1.25}},
+            {"mixed", JSONArray{1, "two", JSONArray{}, JSONObject{{"k", true}}}}
+        };
+
+    assert(parseFromBSON(dumpToBSON(obj)) == obj);
+    assert(parseFromUBJSON(dumpToUBJSON(obj)) == obj);
+    assert(dumpToUBJSON(JSONArray{1, 2, 3}) == std::string("[$i#i\x03\x01\x02\x03", 9));
+    assert(dumpToUBJSON(JSONArray{1, 200}) == std::string("[$U#i\x02\x01\xc8", 8));
+    assert(parseFromUBJSON(std::string("[i\x01N[$U#i\x02\x01\x02]", 13)) == JSONArray({1, JSONArray{1, 2}}));
+
+    JSONObject unicode{{"k", "\\u00e9"}};
+    assert(parseFromBSON(dumpToBSON(unicode))["k"] == "\xc3\xa9");
+
+    bool threw = false;
+    try { dumpToBSON(JSONArray{1}); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    threw = false;
+    try { parseFromBSON(std::string("\x16\x00\x00\x00\x02hel", 9)); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    // typed null/true/false arrays carry no bytes per element, their count is bounded by the remaining input
+    assert(parseFromUBJSON(std::string("[$Z#i\x03", 6)) == JSONArray({nullptr, nullptr, nullptr}));
+    assert(parseFromUBJSON(std::string("[$T#i\x10", 6)).size() == 16);
+
+    for (const std::string& huge : {std::string("[$Z#l\x7f\xff\xff\xff", 9), std::string("[$T#L\x00\x00\x00\x01\x00\x00\x00\x00", 13),
+                                     std::string("[$F#I\x01\x00", 7), std::string("{$Z#l\x00\x01\x00\x00", 9)}) {
+        threw = false;
+        try { parseFromUBJSON(huge); } catch (const JSONException&) { threw = true; }
+        assert(threw);
+    }
+
+    // nesting is limited
+    auto nestedBSON = [](const size_t depth) {
+        // every level is a document holding one array element "0" that contains the next level, the innermost
+        // document is empty. A level adds 8 bytes: length, type, key and the closing NUL.
+        std::string bytes;
+        for (size_t level = depth; level > 0; --level) {
+            uint32_t length = uint32_t(8 * level - 3);
+            for (int shift = 0; shift < 32; shift += 8) {
+                bytes += char((length >> shift) & 0xFF);
+            }
+            if (level > 1) {
+                bytes += std::string("\x04" "0", 3);
+            }
+        }
+        return bytes + std::string(depth, '\0');
+    };
+    assert(parseFromBSON(nestedBSON(BSONCodec::maxDepth)).isMap());
+
+    for (size_t depth : {BSONCodec::maxDepth + 1, size_t(200000)}) {
+        threw = false;
+        try { parseFromBSON(nestedBSON(depth)); } catch (const JSONException&) { threw = true; }
+        assert(threw);
+    }
+
+    // nesting is limited
+    std::string deep = std::string(UBJSONCodec::maxDepth, '[') + std::string(UBJSONCodec::maxDepth, ']');
+    assert(parseFromUBJSON(deep).isArray());
+
+    threw = false;
+    try { parseFromUBJSON("[" + deep + "]"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    threw = false;
+    try { parseFromUBJSON(std::string(1000000, '[')); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    auto obj2 = parseFromFile("testInputs/mediumJson.json");
+    std::string bson = dumpToBSON(JSONObject{{"root", obj2}});
+    assert(dumpToBSON(parseFromBSON(bson)) == bson);
+    std::string ubjson = dumpToUBJSON(obj2);
+    assert(dumpToUBJSON(parseFromUBJSON(ubjson)) == ubjson);
+}
+
+void testStructBinding() {
+    using namespace simpleJSON;
+
+    BoundSample sample = parseStructFromString<BoundSample>(
+            "{\"count\": 3, \"unknown\": {\"nested\": [1, \"x\", null]}, \"ratio\": -0.5, \"text\": \"a\\\"b\","
+            " \"values\": [1, 2, 3], \"flags\": [true, false], \"note\": null, \"actors\": [{\"id\": 7, \"login\": \"l\"}]}");
+
+    assert(sample.count == 3);
+    assert(equals(sample.ratio, -0.5));
+    assert(sample.text == "a\"b");
+    assert((sample.values == std::vector<int>{1, 2, 3}));
+    assert((sample.flags == std::vector<bool>{true, false}));
+    assert(!sample.note.has_value());
+    assert(sample.actors.size() == 1 && sample.actors[0].id == 7 && sample.actors[0].login == "l");
+
+    sample.note = "present";
+    std::string dumped = dumpStructToString(sample);
+    assert(dumped == "{\"count\":3,\"ratio\":-0.5,\"text\":\"a\\\"b\",\"values\":[1,2,3],\"flags\":[true,false],\"note\":\"present\",\"actors\":[{\"id\":7,\"login\":\"l\"}]}");
+    BoundSample reparsed = parseStructFromString<BoundSample>(dumped);
+    assert(reparsed.text == sample.text && reparsed.note == sample.note && reparsed.actors[0].login == "l");
+
+    // unsigned values above the signed range and small doubles survive a round trip
+    BoundNumbers numbers;
+    numbers.counter = std::numeric_limits<unsigned long long>::max();
+    numbers.tiny = 1e-9;
+    numbers.ratio = 0.1f;
+    dumped = dumpStructToString(numbers);
+    assert(dumped == "{\"counter\":18446744073709551615,\"tiny\":1e-9,\"ratio\":0.10000000149011612}");
+    BoundNumbers reparsedNumbers = parseStructFromString<BoundNumbers>(dumped);
+    assert(reparsedNumbers.counter == numbers.counter && reparsedNumbers.tiny == numbers.tiny && reparsedNumbers.ratio == numbers.ratio);
+
+    bool threw = false;
+    numbers.tiny = std::nan("");
+    try { dumpStructToString(numbers); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    threw = false;
+    try { parseStructFromString<BoundSample>("{\"count\": \"three\"}"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    threw = false;
+    try { parseStructFromString<BoundActor>("{\"id\": 1} trailing"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+
+    // numbers follow the JSON grammar
+    for (const char* invalid : {"{\"id\": .5}", "{\"id\": 01}", "{\"id\": 1.}", "{\"id\": +1}", "{\"id\": 1e}", "{\"id\": -}", "{\"id\": 1-2}"}) {
+        threw = false;
+        try { parseStructFromString<BoundActor>(invalid); } catch (const JSONException&) { threw = true; }
+        assert(threw);
+    }
+    threw = false;
+    try { parseStructFromString<BoundSample>("{\"ratio\": .5}"); } catch (const JSONException&) { threw = true; }
+    assert(threw);
+    assert(parseStructFromString<BoundSample>("{\"ratio\": -0.25e1, \"count\": -0}").ratio == -2.5);
+
+    auto events = parseStructFromFile<std::vector<BoundEvent>>("testInputs/mediumJson.json");
+    auto dom = parseFromFile("testInputs/mediumJson.json");
+    assert(events.size() == dom.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        assert(dom[i]["id"] == events[i].id);
+        assert(dom[i]["actor"]["login"] == events[i].actor.login);
+        assert(dom[i]["actor"]["id"] == events[i].actor.id);
+        assert(dom[i]["public"] == events[i].isPublic);
+        assert(events[i].org.has_value() == (dom[i].asMap().count("org") > 0 && !dom[i]["org"].isNull()));
+    }
+}
+
 int main () {
     testJSONString();
     testJSONNumber();
     testJSONBool();
     testJSONNull();
     testJSONArray();
+    testPackedArrays();
+    testArrayAggregation();
+    testJSONPointer();
+    testArrayIndex();
+    testArraySort();
+    testStaticJSON();
     testJSONObject();
+    testPrettyPrintOptions();
+    testMeasure();
+    testCanonicalJSON();
+    testJSONKey();
+    testConcurrentReads();
+    testSharedDocument();
+    testParseBatch();
+    testParseFiles();
+    testParallelDump();
+    testParallelCompare();
 
     testStreamIO();
+    testStreamParser();
+    testPipelinedLoading();
+    testJSONWriter();
+    testJSONFilter();
+    testMinifyPrettify();
+    testSnapshot();
+    testBinaryCodecs();
+    testStructBinding();
 
     return 0;
 }
\ No newline at end of file